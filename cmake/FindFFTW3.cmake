@@ -0,0 +1,6 @@
+#
+# Find FFTW3 (single precision)
+#
+include(FindPkgConfig)
+
+pkg_check_modules(FFTW3 fftw3f)
@@ -45,10 +45,12 @@
 #include "Subtract.h"
 #include "Concatenate.h"
 #include "Delta.h"
+#include "Deltas.h"
 #include "Variance.h"
 #include "Divide.h"
 #include "ZeroFilter.h"
 #include "Periodogram.h"
+#include "ShortTimeSpectrum.h"
 #include "MelFilter.h"
 #include "Cepstrum.h"
 #include "Frame.h"
@@ -68,11 +70,8 @@
 # include "BSAPIFastVTLN.h"
 #endif
 
-#ifdef HAVE_TORCH3
-# include "MLP.h"
-# include "MLPVAD.h"
-# undef real
-#endif
+#include "MLP.h"
+#include "MLPVAD.h"
 
 #ifdef HAVE_SPTK
 # include "MCep.h"
@@ -81,6 +80,7 @@
 #include "Pixmap.h"
 
 #include "Energy.h"
+#include "SpectralEnergy.h"
 #include "VADGate.h"
 #include "Modulation.h"
 #include "NoiseVAD.h"
@@ -129,10 +129,8 @@ Tracter::ASRFactory::ASRFactory(const char* iObjectName)
     RegisterFrontend(new PLPGraphFactory);
     RegisterFrontend(new PLPVADGraphFactory);
 
-#ifdef HAVE_TORCH3
     RegisterFrontend(new BasicMLPVADGraphFactory);
     RegisterFrontend(new MLPVADGraphFactory);
-#endif
 
 #ifdef HAVE_HTKLIB
     RegisterFrontend(new HTKGraphFactory);
@@ -183,11 +181,9 @@ Tracter::Component<float>* Tracter::ASRFactory::CreateSource(
     else
         throw Exception("ASRFactory: Unknown source %s\n", source);
 
-#ifdef HAVE_RESAMPLE
     // Not sure if here is the right place...
     if (GetEnv("Resample", 0))
         component = new Resample(component);
-#endif
 
     return component;
 }
@@ -203,7 +199,12 @@ Tracter::ASRFactory::CreateFrontend(Component<float>* iComponent)
 
     const char* frontend = GetEnv("Frontend", "Null");
     if (mFrontend[frontend])
+    {
+        // Components are only shared within a graph
+        mFrontend[frontend]->Forget();
         component = mFrontend[frontend]->Create(iComponent);
+        mFrontend[frontend]->Forget();
+    }
     else
         throw Exception("ASRFactory: Unknown frontend %s\n", frontend);
 
@@ -322,30 +323,69 @@ Tracter::LNASourceFactory::Create(ISource*& iSource)
 }
 
 /**
- * Instantiates an arbitrary graph of Delta components
+ * Instantiates static features with deltas up to DeltaOrder.  By
+ * default this is one Deltas component; if Deltas is unset it is the
+ * original graph of Delta components and a Concatenate.
  */
 Tracter::Component<float>*
 Tracter::GraphFactory::deltas(Component<float>* iComponent)
 {
     Component<float>* component = iComponent;
     int deltaOrder = GetEnv("DeltaOrder", 0);
-    if (deltaOrder > 0)
+    if (deltaOrder <= 0)
+        return component;
+
+    if (GetEnv("Deltas", 1))
+        return new Deltas(component, deltaOrder);
+
+    Concatenate* c = new Concatenate();
+    c->Add(component);
+    for (int i=0; i<deltaOrder; i++)
     {
-        Concatenate* c = new Concatenate();
-        c->Add(component);
-        for (int i=0; i<deltaOrder; i++)
-        {
-            // For the moment, there is a bug where the components don't
-            // copy this string, so the pointer becomes invalid.
-            //char str[10];
-            //sprintf(str, "Delta%d", i+1);
-            //Delta* d = new Delta(component, str); 
-            Delta* d = new Delta(component);
-            c->Add(d);
-            component = d;
-        }
-        component = c;
+        // For the moment, there is a bug where the components don't
+        // copy this string, so the pointer becomes invalid.
+        //char str[10];
+        //sprintf(str, "Delta%d", i+1);
+        //Delta* d = new Delta(component, str); 
+        Delta* d = new Delta(component);
+        c->Add(d);
+        component = d;
     }
+    return c;
+}
+
+/**
+ * Instantiates a power spectrum, either as Frame and Periodogram or
+ * as the equivalent fused ShortTimeSpectrum
+ */
+Tracter::Component<float>*
+Tracter::GraphFactory::spectrum(Component<float>* iComponent)
+{
+    if (GetEnv("ShortTimeSpectrum", 0))
+        return shared<ShortTimeSpectrum>(iComponent);
+
+    Component<float>* component = iComponent;
+    component = shared<Frame>(component);
+    component = shared<Periodogram>(component);
+    return component;
+}
+
+/**
+ * Instantiates a frame energy for a VAD.  By default this is a
+ * separate framing of iComponent.  If SpectralEnergy is set, it is
+ * instead taken from iSpectrum, the power spectrum of the main
+ * branch, so the signal is only framed once.
+ */
+Tracter::Component<float>* Tracter::GraphFactory::energy(
+    Component<float>* iComponent, Component<float>* iSpectrum
+)
+{
+    if (GetEnv("SpectralEnergy", 0))
+        return shared<SpectralEnergy>(iSpectrum);
+
+    Component<float>* component = iComponent;
+    component = shared<Frame>(component);
+    component = shared<Energy>(component);
     return component;
 }
 
@@ -359,7 +399,7 @@ Tracter::GraphFactory::normaliseMean(Component<float>* iComponent)
     bool cmn = GetEnv("NormaliseMean", 1);
     if (cmn)
     {
-        Mean* m = new Mean(iComponent);
+        Mean* m = shared<Mean>(iComponent);
         Subtract* s = new Subtract(iComponent, m);
         component = s;
     }
@@ -419,8 +459,7 @@ Tracter::BasicGraphFactory::Create(Component<float>* iComponent)
 {
     Component<float>* p = iComponent;
     p = new ZeroFilter(p);
-    p = new Frame(p);
-    p = new Periodogram(p);
+    p = spectrum(p);
     p = new MelFilter(p);
     p = new Cepstrum(p);
     p = normaliseMean(p);
@@ -437,8 +476,8 @@ Tracter::BasicSpeechDetGraphFactory::Create(Component<float>* iComponent)
 {
     Component<float>* p = iComponent;
     p = new ZeroFilter(p);
-    p = new Frame(p);
-    p = new Periodogram(p);
+    p = spectrum(p);
+    Component<float>* s = p;
     p = new MelFilter(p);
     p = new Cepstrum(p);
     p = normaliseMean(p);
@@ -446,9 +485,7 @@ Tracter::BasicSpeechDetGraphFactory::Create(Component<float>* iComponent)
     p = normaliseVariance(p);
 
     // Minima-based VAD
-    Component<float>* v = iComponent;
-    v = new Frame(v);
-    v = new Energy(v);
+    Component<float>* v = energy(iComponent, s);
     Modulation* m = new Modulation(v);
     Component<float>* n = new Minima(v);
     Component<BoolType>* b = new Comparator(m, n);
@@ -457,9 +494,7 @@ Tracter::BasicSpeechDetGraphFactory::Create(Component<float>* iComponent)
     // Concatenation
     Concatenate* c = new Concatenate();
 
-#ifdef HAVE_TORCH3
     p = new MLP(p);
-#endif
     c->Add(p);
     c->Add(f);
 
@@ -476,8 +511,8 @@ Tracter::BasicVADGraphFactory::Create(Component<float>* iComponent)
     /* Basic signal processing chain */
     Component<float>* p = iComponent;
     p = new ZeroFilter(p);
-    p = new Frame(p);
-    p = new Periodogram(p);
+    p = spectrum(p);
+    Component<float>* s = p;
     p = new MelFilter(p);
     p = new Cepstrum(p);
     p = normaliseMean(p);
@@ -485,9 +520,7 @@ Tracter::BasicVADGraphFactory::Create(Component<float>* iComponent)
     p = normaliseVariance(p);
 
     /* VAD */
-    Component<float>* v = iComponent;
-    v = new Frame(v);
-    v = new Energy(v);
+    Component<float>* v = energy(iComponent, s);
     Modulation* m = new Modulation(v);
     if (!GetEnv("MinimaVAD", 0))
     {
@@ -507,7 +540,6 @@ Tracter::BasicVADGraphFactory::Create(Component<float>* iComponent)
     return v;
 }
 
-#ifdef HAVE_TORCH3
 /**
  * Instantiates a basic MFCC frontend with MLPVAD and VADGate
  * components.
@@ -518,8 +550,7 @@ Tracter::BasicMLPVADGraphFactory::Create(Component<float>* iComponent)
     /* Basic signal processing chain */
     Component<float>* p = iComponent;
     p = new ZeroFilter(p);
-    p = new Frame(p);
-    p = new Periodogram(p);
+    p = spectrum(p);
     p = new MelFilter(p);
     p = new Cepstrum(p);
     p = normaliseMean(p);
@@ -549,7 +580,6 @@ Tracter::MLPVADGraphFactory::Create(Component<float>* iComponent)
 
     return p;
 }
-#endif
 
 /**
  * Instantiates a PLP frontend.
@@ -559,8 +589,7 @@ Tracter::PLPGraphFactory::Create(Component<float>* iComponent)
 {
     Component<float>* p = iComponent;
     p = new ZeroFilter(p);
-    p = new Frame(p);
-    p = new Periodogram(p);
+    p = spectrum(p);
     p = new MelFilter(p);
     p = new LPCepstrum(p);
     p = normaliseMean(p);
@@ -578,8 +607,8 @@ Tracter::PLPVADGraphFactory::Create(Component<float>* iComponent)
 {
     Component<float>* p = iComponent;
     p = new ZeroFilter(p);
-    p = new Frame(p);
-    p = new Periodogram(p);
+    p = spectrum(p);
+    Component<float>* s = p;
     p = new MelFilter(p);
     p = new LPCepstrum(p);
     p = normaliseMean(p);
@@ -587,9 +616,7 @@ Tracter::PLPVADGraphFactory::Create(Component<float>* iComponent)
     p = normaliseVariance(p);
 
     /* VAD */
-    Component<float>* v = iComponent;
-    v = new Frame(v);
-    v = new Energy(v);
+    Component<float>* v = energy(iComponent, s);
     Modulation* m = new Modulation(v);
     if (!GetEnv("MinimaVAD", 0))
     {
@@ -633,9 +660,8 @@ Tracter::PLPPosteriorGraphFactory::Create(Component<float>* iComponent)
     Component<float>* p  = iComponent;
 
     // Framed version of the input for BSAPI
-    Component<float>* f = new Frame(p);
+    Component<float>* f = shared<Frame>(p);
 
-#ifdef HAVE_TORCH3
     // MLP based VAD
     p = new BSAPIFrontEnd(f, "PLPFrontEnd");
     Mean* mlpm = new Mean(p);
@@ -645,14 +671,6 @@ Tracter::PLPPosteriorGraphFactory::Create(Component<float>* iComponent)
     p = new MLP(p);
     MLPVAD* m = new MLPVAD(p);
     p = new VADGate(f, m);
-#else
-    // Energy based VAD
-    p = new Frame(p);
-    p = new Energy(p);
-    Modulation* m = new Modulation(p);
-    NoiseVAD* mv = new NoiseVAD(m, p)
-    p = new VADGate(f, mv);
-#endif
 
     // VTLN PLP
     Component<float>* wf = new BSAPIFastVTLN(p);
@@ -699,9 +717,8 @@ Tracter::PLPvtlnGraphFactory::Create(Component<float>* iComponent)
     Component<float>* p  = iComponent;
 
     // Framed version of the input for BSAPI
-    Component<float>* f = new Frame(p);
+    Component<float>* f = shared<Frame>(p);
 
-#ifdef HAVE_TORCH3
     // MLP based VAD
     p = new BSAPIFrontEnd(f, "PLPFrontEnd");
     Mean* mlpm = new Mean(p);
@@ -711,14 +728,6 @@ Tracter::PLPvtlnGraphFactory::Create(Component<float>* iComponent)
     p = new MLP(p);
     MLPVAD* m = new MLPVAD(p);
     p = new VADGate(f, m);
-#else
-    // Energy based VAD
-    p = new Frame(p);
-    p = new Energy(p);
-    Modulation* m = new Modulation(p);
-    NoiseVAD* mv = new NoiseVAD(m, p)
-    p = new VADGate(f, mv);
-#endif
 
     // VTLN PLP
     Component<float>* wf = new BSAPIFastVTLN(p);
@@ -746,11 +755,11 @@ Tracter::BSAPIGraphFactory::Create(Component<float>* iComponent)
     Component<float>* p  = iComponent;
 
     // Framed version of the input for BSAPI
-    Component<float>* f = new Frame(p);
+    Component<float>* f = shared<Frame>(p);
 
     // Energy based VAD
-    p = new Frame(p);
-    p = new Energy(p);
+    p = shared<Frame>(p);
+    p = shared<Energy>(p);
     Modulation* m = new Modulation(p);
     NoiseVAD* mv = new NoiseVAD(m, p);
     p = new VADGate(f, mv);
@@ -774,8 +783,7 @@ Tracter::Component<float>*
 Tracter::MCepGraphFactory::Create(Component<float>* iComponent)
 {
     Component<float>* p = iComponent;
-    p = new Frame(p);
-    p = new Periodogram(p);
+    p = spectrum(p);
     p = new MCep(p);
     p = normaliseMean(p);
     p = deltas(p);
@@ -792,8 +800,7 @@ Tracter::SNRGraphFactory::Create(Component<float>* iComponent)
 {
     Component<float>* p = iComponent;
     p = new ZeroFilter(p);
-    p = new Frame(p);
-    p = new Periodogram(p);
+    p = spectrum(p);
     Component<float>* m = new Minima(p);
     m = new TransverseFilter(m);
     p = new SNRSpectrum(p, m);
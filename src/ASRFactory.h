@@ -10,6 +10,8 @@
 
 #include <map>
 #include <string>
+#include <typeinfo>
+#include <utility>
 
 #include "TracterObject.h"
 #include "Component.h"
@@ -60,10 +62,44 @@ namespace Tracter
         virtual ~GraphFactory() throw () {}
         virtual Component<float>* Create(Component<float>* iComponent) = 0;
 
+        /** Forget the components shared within the last graph */
+        void Forget()
+        {
+            mShared.clear();
+        }
+
     protected:
+        /**
+         * Returns a component of type T, with the default object
+         * name, on iInput.  If the graph already has one, that is
+         * returned rather than a duplicate; the parameters come from
+         * the environment via the object name, so it would do the
+         * same computation.  Initialise() sizes its cache for the
+         * extra output.
+         */
+        template <class T>
+        T* shared(Component<float>* iInput)
+        {
+            ComponentBase*& component = mShared[
+                std::make_pair(std::string(typeid(T).name()), iInput)
+            ];
+            if (!component)
+                component = new T(iInput);
+            return static_cast<T*>(component);
+        }
+
         Component<float>* deltas(Component<float>* iComponent);
+        Component<float>* spectrum(Component<float>* iComponent);
+        Component<float>* energy(
+            Component<float>* iComponent, Component<float>* iSpectrum
+        );
         Component<float>* normaliseMean(Component<float>* iComponent);
         Component<float>* normaliseVariance(Component<float>* iComponent);
+
+    private:
+        std::map<
+            std::pair<std::string, ComponentBase*>, ComponentBase*
+        > mShared;
     };
 
     DECLARE_SOURCE_FACTORY(File)
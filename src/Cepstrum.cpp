@@ -7,7 +7,9 @@
 
 #include <cmath>
 #include <cfloat>
+#include <algorithm>
 
+#include "Kernel.h"
 #include "Cepstrum.h"
 
 Tracter::Cepstrum::Cepstrum(
@@ -17,12 +19,13 @@ Tracter::Cepstrum::Cepstrum(
 {
     mObjectName = iObjectName;
     mInput = iInput;
-    Connect(iInput);
+    mBlock = GetEnv("Block", 8);
+    assert(mBlock > 0);
+    Connect(iInput, mBlock);
 
     mNLogData = mInput->Frame().size;
 
     mFloor = GetEnv("Floor", 1e-8f);
-    mLogFloor = logf(mFloor);
     mFloored = 0;
     mC0 = GetEnv("C0", 1);
     mNCepstra = GetEnv("NCepstra", 12);
@@ -33,7 +36,20 @@ Tracter::Cepstrum::Cepstrum(
 
     mLogData = 0;
     mCepstra = 0;
-    mFourier.Init(mNLogData, &mLogData, &mCepstra);
+    mTable = GetEnv("Table", DCTTable::Cheaper(mNLogData, mFrame.size));
+    if (mTable)
+    {
+        // Output in HTK order (C0 last, if at all)
+        std::vector<int> coeff;
+        for (int i=0; i<mNCepstra; i++)
+            coeff.push_back(i+1);
+        if (mC0)
+            coeff.push_back(0);
+        mDCT.Init(mNLogData, coeff);
+        mBlockData.resize(mBlock * mNLogData);
+    }
+    else
+        mFourier.Init(mNLogData, &mLogData, &mCepstra);
 }
 
 Tracter::Cepstrum::~Cepstrum() throw()
@@ -42,33 +58,66 @@ Tracter::Cepstrum::~Cepstrum() throw()
         Verbose(1, "floored %d values < %e\n", mFloored, mFloor);
 }
 
-bool Tracter::Cepstrum::UnaryFetch(IndexType iIndex, float* oData)
+Tracter::SizeType Tracter::Cepstrum::ContiguousFetch(
+    IndexType iIndex, SizeType iLength, SizeType iOffset
+)
 {
     assert(iIndex >= 0);
 
-    // Read the input frame
-    const float* p = mInput->UnaryRead(iIndex);
-    if (!p)
-        return false;
+    SizeType done = 0;
+    while (done < iLength)
+    {
+        CacheArea inputArea;
+        SizeType len = std::min(iLength - done, (SizeType)mBlock);
+        SizeType got = mInput->Read(inputArea, iIndex + done, len);
+        for (SizeType i=0; i<got; i++)
+        {
+            const float* p = (i < inputArea.len[0])
+                ? mInput->GetPointer(inputArea.offset + i)
+                : mInput->GetPointer(i - inputArea.len[0]);
+            if (mTable)
+            {
+                log(p, &mBlockData[i * mNLogData]);
+                continue;
+            }
+
+            // Do the DCT
+            log(p, mLogData);
+            mFourier.Transform();
+
+            // Copy to output in HTK order (C0 last, if at all)
+            float* output = GetPointer(iOffset + done + i);
+            for (int j=0; j<mNCepstra; j++)
+                output[j] = mCepstra[j+1];
+            if (mC0)
+                output[mNCepstra] = mCepstra[0];
+        }
+
+        // The table is already in output order
+        if (mTable)
+            mDCT.Transform(&mBlockData[0], mNLogData,
+                           GetPointer(iOffset + done), mFrame.size, got);
+
+        done += got;
+        if (got < len)
+            break;
+    }
 
-    // Copy the frame though a log function
+    return done;
+}
+
+/**
+ * Copy a frame through a floor and a log function.
+ */
+void Tracter::Cepstrum::log(const float* iInput, float* oLog)
+{
     for (int i=0; i<mNLogData; i++)
-        if (p[i] > mFloor)
-            mLogData[i] = logf(p[i]);
+        if (iInput[i] > mFloor)
+            oLog[i] = iInput[i];
         else
         {
-            mLogData[i] = mLogFloor;
+            oLog[i] = mFloor;
             mFloored++;
         }
-
-    // Do the DCT
-    mFourier.Transform();
-
-    // Copy to output in HTK order (C0 last, if at all)
-    for (int i=0; i<mNCepstra; i++)
-        oData[i] = mCepstra[i+1];
-    if (mC0)
-        oData[mNCepstra] = mCepstra[0];
-
-    return true;
+    Kernel::Log(oLog, oLog, mNLogData);
 }
@@ -8,13 +8,18 @@
 #ifndef CEPSTRUM_H
 #define CEPSTRUM_H
 
+#include <vector>
+
 #include "Fourier.h"
+#include "DCTTable.h"
 #include "CachedComponent.h"
 
 namespace Tracter
 {
     /**
-     * Generate the cepstrum of an input
+     * Generate the cepstrum of an input.  For small orders (or if
+     * Table is set) the DCT is done by a DCTTable on up to Block
+     * frames at once; otherwise by a Fourier transform per frame.
      */
     class Cepstrum : public CachedComponent<float>
     {
@@ -23,19 +28,26 @@ namespace Tracter
         virtual ~Cepstrum() throw();
 
     protected:
-        bool UnaryFetch(IndexType iIndex, float* oData);
+        SizeType ContiguousFetch(
+            IndexType iIndex, SizeType iLength, SizeType iOffset
+        );
 
     private:
         Component<float>* mInput;
         float mFloor;
-        float mLogFloor;
         int mFloored;
         int mNLogData;
         int mNCepstra;
         float* mLogData;
         float* mCepstra;
         bool mC0;
+        int mBlock;
+        bool mTable;
         Fourier mFourier;
+        DCTTable mDCT;
+        std::vector<float> mBlockData;
+
+        void log(const float* iInput, float* oLog);
     };
 }
 
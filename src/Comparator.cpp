@@ -9,6 +9,7 @@
 
 #include <cstdio>
 #include <cmath>
+#include <algorithm>
 
 #include "Comparator.h"
 
@@ -21,8 +22,10 @@ Tracter::Comparator::Comparator(
     mObjectName = iObjectName;
     mInput1 = iInput1;
     mInput2 = iInput2;
-    Connect(iInput1);
-    Connect(iInput2);
+    mBlock = GetEnv("Block", 8);
+    assert(mBlock > 0);
+    Connect(iInput1, mBlock);
+    Connect(iInput2, mBlock);
 
     mShowGuts = GetEnv("ShowGuts", 0);
 
@@ -31,30 +34,49 @@ Tracter::Comparator::Comparator(
     mThreshold = powf(10.0f, dBThres / 10.0f);
 }
 
-bool Tracter::Comparator::UnaryFetch(IndexType iIndex, BoolType* oData)
+Tracter::SizeType Tracter::Comparator::ContiguousFetch(
+    IndexType iIndex, SizeType iLength, SizeType iOffset
+)
 {
     Verbose(3, "iIndex %ld\n", iIndex);
 
-    /* Read and compare */
-    const float* input1 = mInput1->UnaryRead(iIndex);
-    if (!input1)
-        return false;
-    const float* input2 = mInput2->UnaryRead(iIndex);
-    if (!input2)
-        return false;
-
-    BoolType state = (*input1 > *input2 * mThreshold) ? true : false;
-    *oData = state;
-
-    /* Feedback */
-    if (sVerbose >= 4) // ie, dont always do the log calculations
-        Verbose(4, "plot %ld %e %e %e %d\n",
-                iIndex,
-                10.0*log10f(*input1),
-                10.0*log10f(*input2),
-                10.0*log10f(*input2 * mThreshold),
-                (int)(state ? 0 : -10)
-        );
-
-    return true;
+    SizeType done = 0;
+    while (done < iLength)
+    {
+        /* Read a block of each input */
+        IndexType index = iIndex + done;
+        SizeType len = std::min(iLength - done, (SizeType)mBlock);
+        CacheArea area1;
+        CacheArea area2;
+        SizeType got = mInput1->Read(area1, index, len);
+        got = mInput2->Read(area2, index, got);
+
+        /* Compare */
+        for (SizeType i=0; i<got; i++)
+        {
+            const float* input1 = mInput1->GetPointer(
+                i < area1.len[0] ? area1.offset + i : i - area1.len[0]
+            );
+            const float* input2 = mInput2->GetPointer(
+                i < area2.len[0] ? area2.offset + i : i - area2.len[0]
+            );
+            BoolType state = (*input1 > *input2 * mThreshold) ? true : false;
+            *GetPointer(iOffset + done + i) = state;
+
+            /* Feedback */
+            if (sVerbose >= 4) // ie, dont always do the log calculations
+                Verbose(4, "plot %ld %e %e %e %d\n",
+                        index + i,
+                        10.0*log10f(*input1),
+                        10.0*log10f(*input2),
+                        10.0*log10f(*input2 * mThreshold),
+                        (int)(state ? 0 : -10)
+                );
+        }
+        done += got;
+        if (got < len)
+            break;
+    }
+
+    return done;
 }
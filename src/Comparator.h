@@ -15,7 +15,8 @@
 namespace Tracter
 {
     /**
-     * A comparator, ostensibly for building a VAD
+     * A comparator, ostensibly for building a VAD.  Compares blocks
+     * of up to Block frames at a time.
      */
     class Comparator : public CachedComponent<BoolType>
     {
@@ -26,7 +27,9 @@ namespace Tracter
 
     protected:
 
-        bool UnaryFetch(IndexType iIndex, BoolType* oData);
+        SizeType ContiguousFetch(
+            IndexType iIndex, SizeType iLength, SizeType iOffset
+        );
 
         void DotHook()
         {
@@ -40,6 +43,7 @@ namespace Tracter
         Component<float>* mInput2;
         float mThreshold;
         bool mShowGuts;
+        int mBlock;
     };
 }
 
@@ -6,6 +6,7 @@
  */
 
 #include <cmath>
+#include <algorithm>
 
 #include "CosineTransform.h"
 
@@ -22,14 +23,27 @@ Tracter::CosineTransform::CosineTransform(
 
     mIData = 0;
     mOData = 0;
-    mDCT.Init(mFrame.size, &mIData, &mOData);
+    mCZeroIndex = GetEnv("CZeroIndex", 0);
+    if (GetEnv("Table", DCTTable::Cheaper(mFrame.size, mFrame.size)))
+    {
+        // The table can produce the output order directly
+        std::vector<int> coeff;
+        for (int i=0; i<mCZeroIndex; i++)
+            coeff.push_back(i+1);
+        coeff.push_back(0);
+        for (int i=std::max(mCZeroIndex+1, 1); i<mFrame.size; i++)
+            coeff.push_back(i);
+        mTable.Init(mFrame.size, coeff);
+        mTableData.resize(mFrame.size);
+        mIData = &mTableData[0];
+    }
+    else
+        mDCT.Init(mFrame.size, &mIData, &mOData);
 
     if (GetEnv("Window", 0))
         mWindow = new Window(mObjectName, mFrame.size);
     else
         mWindow = 0;
-
-    mCZeroIndex = GetEnv("CZeroIndex", 0);
 }
 
 bool Tracter::CosineTransform::UnaryFetch(IndexType iIndex, float* oData)
@@ -48,6 +62,11 @@ bool Tracter::CosineTransform::UnaryFetch(IndexType iIndex, float* oData)
             mIData[i] = ip[i];
 
     // DCT
+    if (mTable.Size())
+    {
+        mTable.Transform(mIData, oData);
+        return true;
+    }
     mDCT.Transform();
 
     // Copy to output
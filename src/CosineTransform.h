@@ -9,11 +9,18 @@
 #define COSINETRANSFORM_H
 
 #include "Window.h"
+#include <vector>
+
 #include "Fourier.h"
+#include "DCTTable.h"
 #include "CachedComponent.h"
 
 namespace Tracter
 {
+    /**
+     * Type II DCT of each frame.  For small sizes (or if Table is set)
+     * it is done by a DCTTable rather than a Fourier transform.
+     */
     class CosineTransform : public CachedComponent<float>
     {
     public:
@@ -29,6 +36,8 @@ namespace Tracter
     private:
         Component<float>* mInput;
         Fourier mDCT;
+        DCTTable mTable;
+        std::vector<float> mTableData;
         float* mIData;
         float* mOData;
         Window* mWindow;
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <cassert>
+#include <cmath>
+
+#include "Kernel.h"
+#include "DCTTable.h"
+
+/**
+ * Initialise for input of size iOrder, calculating the coefficients
+ * iCoeff in that order.
+ */
+void Tracter::DCTTable::Init(int iOrder, const std::vector<int>& iCoeff)
+{
+    assert(iOrder > 0);
+    mOrder = iOrder;
+    mCoeff = iCoeff;
+    mMatrix.resize(mCoeff.size() * iOrder);
+    for (int r=0; r<(int)mCoeff.size(); r++)
+    {
+        int k = mCoeff[r];
+        assert((k >= 0) && (k < iOrder));
+        for (int n=0; n<iOrder; n++)
+            mMatrix[r*iOrder + n] =
+                (float)(2.0 * cos(M_PI * k * (n + 0.5) / iOrder));
+    }
+}
+
+/**
+ * Initialise for all iOrder coefficients in the natural order.
+ */
+void Tracter::DCTTable::Init(int iOrder)
+{
+    std::vector<int> coeff(iOrder);
+    for (int i=0; i<iOrder; i++)
+        coeff[i] = i;
+    Init(iOrder, coeff);
+}
+
+void Tracter::DCTTable::Transform(const float* iInput, float* oOutput) const
+{
+    Transform(iInput, mOrder, oOutput, Size(), 1);
+}
+
+/**
+ * Transform iNFrames frames in one matrix multiplication.
+ */
+void Tracter::DCTTable::Transform(
+    const float* iInput, int iInputStride,
+    float* oOutput, int iOutputStride, int iNFrames
+) const
+{
+    assert(mOrder > 0);
+    Kernel::MatrixMultiply(
+        &mMatrix[0], Size(), mOrder,
+        iInput, iInputStride, oOutput, iOutputStride, iNFrames
+    );
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#ifndef DCTTABLE_H
+#define DCTTABLE_H
+
+#include <vector>
+
+namespace Tracter
+{
+    /**
+     * Table driven DCT.  A type II DCT, scaled as Fourier's real to
+     * real transform, done as a matrix multiplication.  Only the
+     * coefficients asked for are calculated, and in the order asked
+     * for, so for small orders this is much cheaper than an FFT.
+     */
+    class DCTTable
+    {
+    public:
+        DCTTable() { mOrder = 0; }
+
+        void Init(int iOrder, const std::vector<int>& iCoeff);
+        void Init(int iOrder);
+
+        /** Number of output coefficients */
+        int Size() const { return mCoeff.size(); }
+
+        void Transform(const float* iInput, float* oOutput) const;
+        void Transform(
+            const float* iInput, int iInputStride,
+            float* oOutput, int iOutputStride, int iNFrames
+        ) const;
+
+        /**
+         * Rule of thumb for when the table is cheaper than the FFT.
+         * Deliberately generous, as FFT plans have a fixed overhead.
+         */
+        static bool Cheaper(int iOrder, int iNCoeffs)
+        {
+            return iOrder * iNCoeffs <= 4096;
+        }
+
+    private:
+        int mOrder;
+        std::vector<int> mCoeff;
+        std::vector<float> mMatrix;
+    };
+}
+
+#endif /* DCTTABLE_H */
@@ -0,0 +1,145 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <algorithm>
+
+#include "Deltas.h"
+
+Tracter::Deltas::Deltas(
+    Component<float>* iInput, int iOrder, const char* iObjectName
+)
+{
+    mObjectName = iObjectName;
+    mInput = iInput;
+    mOrder = iOrder;
+    assert(mOrder > 0);
+    mSize = iInput->Frame().size;
+    assert(mSize > 0);
+    mFrame.size = mSize * (mOrder+1);
+
+    mTheta = GetEnv("Theta", 2);
+    assert(mTheta > 0);
+    mWindow = mTheta*2 + 1;
+
+    // The top order needs the input this far either side
+    int reach = mTheta * mOrder;
+    Connect(mInput, reach*2 + 1, reach);
+
+    // Set the weights in advance, as Delta
+    mWeight.resize(mWindow);
+    float denom = 0.0f;
+    for (int i=1; i<=mTheta; i++)
+        denom += 2.0*i*i;
+    for (int i=0; i<mWindow; i++)
+        mWeight[i] = (float)(i - mTheta) / denom;
+
+    // Each order keeps enough frames for the order above
+    mRingSize = reach*2 + 1;
+    mRing.resize(mOrder+1);
+    mRingIndex.resize(mOrder+1);
+    for (int k=1; k<=mOrder; k++)
+    {
+        mRing[k].resize(mRingSize * mSize);
+        mRingIndex[k].assign(mRingSize, -1);
+    }
+    mEnd = -1;
+}
+
+void Tracter::Deltas::Reset(bool iPropagate)
+{
+    mEnd = -1;
+    for (int k=1; k<=mOrder; k++)
+        mRingIndex[k].assign(mRingSize, -1);
+    CachedComponent<float>::Reset(iPropagate);
+}
+
+bool Tracter::Deltas::UnaryFetch(IndexType iIndex, float* oData)
+{
+    assert(iIndex >= 0);
+
+    // Read the whole reach at once.  If iIndex has jumped (e.g., when
+    // downstream of a Gate), this restarts the input cache at the
+    // earliest frame needed rather than at iIndex.
+    IndexType reach = mTheta * mOrder;
+    IndexType first = std::max(iIndex - reach, (IndexType)0);
+    CacheArea inputArea;
+    mInput->Read(inputArea, first, iIndex + reach - first + 1);
+
+    if (clamp(0, iIndex) != iIndex)
+        return false;
+
+    for (int k=0; k<=mOrder; k++)
+    {
+        const float* p = frame(k, iIndex);
+        for (int j=0; j<mSize; j++)
+            oData[k*mSize + j] = p[j];
+    }
+
+    return true;
+}
+
+/**
+ * Map an index of order iOrder onto one that exists, handling the
+ * edges as a chain of Delta components would: indices before the
+ * start are replaced by the first frame, and after the end by the
+ * last.  Each Delta runs Theta frames beyond the end of its input, so
+ * order k has Theta*k more frames than the input.
+ */
+Tracter::IndexType Tracter::Deltas::clamp(int iOrder, IndexType iIndex)
+{
+    if (iIndex < 0)
+        iIndex = 0;
+
+    // The input frame that must exist for iIndex to exist
+    IndexType input = std::max(iIndex - iOrder*mTheta, (IndexType)0);
+    if (mEnd < 0)
+    {
+        if (mInput->UnaryRead(input))
+            return iIndex;
+
+        // Off the end; the end must be within reach
+        mEnd = input;
+        while ((mEnd > 0) && !mInput->UnaryRead(mEnd-1))
+            mEnd--;
+    }
+
+    if (input < mEnd)
+        return iIndex;
+    return mEnd - 1 + iOrder*mTheta;
+}
+
+/**
+ * Order iOrder at index iIndex, where order 0 is the input itself.
+ * Higher orders are calculated from the order below, and the result
+ * kept for re-use.  The sum is in the same order as Delta's so the
+ * results are identical.
+ */
+const float* Tracter::Deltas::frame(int iOrder, IndexType iIndex)
+{
+    iIndex = clamp(iOrder, iIndex);
+    assert(iIndex >= 0);
+    if (iOrder == 0)
+        return mInput->UnaryRead(iIndex);
+
+    int slot = iIndex % mRingSize;
+    float* data = &mRing[iOrder][slot * mSize];
+    if (mRingIndex[iOrder][slot] == iIndex)
+        return data;
+
+    for (int j=0; j<mSize; j++)
+        data[j] = 0.0f;
+    for (int i=0; i<mWindow; i++)
+    {
+        if (i == mTheta)  // The weight is zero
+            continue;
+        const float* p = frame(iOrder-1, iIndex + i - mTheta);
+        for (int j=0; j<mSize; j++)
+            data[j] += p[j] * mWeight[i];
+    }
+    mRingIndex[iOrder][slot] = iIndex;
+
+    return data;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#ifndef DELTAS_H
+#define DELTAS_H
+
+#include <vector>
+
+#include "CachedComponent.h"
+
+namespace Tracter
+{
+    /**
+     * Static features with their deltas, delta-deltas and so on up to
+     * iOrder, concatenated into one vector.  The output is identical
+     * to a Concatenate of the input and a chain of Delta components,
+     * including the edge effects, but each order is calculated just
+     * once per frame and kept in a small ring for the next order up.
+     * Within an order, the regression is still a direct sum over the
+     * window: a running sum would cost as much for the usual Theta of
+     * 2, and would drift from Delta's results over a long stream.
+     * The object name defaults to that of Delta, so they share
+     * configuration (Theta).
+     */
+    class Deltas : public CachedComponent<float>
+    {
+    public:
+        Deltas(
+            Component<float>* iInput, int iOrder,
+            const char* iObjectName = "Delta"
+        );
+        virtual ~Deltas() throw() {}
+        virtual void Reset(bool iPropagate);
+
+    protected:
+        bool UnaryFetch(IndexType iIndex, float* oData);
+
+        void DotHook()
+        {
+            CachedComponent<float>::DotHook();
+            DotRecord(1, "order=%d", mOrder);
+            DotRecord(1, "win=%d=%d+1+%d", mWindow, mTheta, mTheta);
+        }
+
+    private:
+        Component<float>* mInput;
+        int mOrder;
+        int mTheta;
+        int mWindow;
+        int mSize;
+        int mRingSize;
+        IndexType mEnd;
+        std::vector<float> mWeight;
+        std::vector< std::vector<float> > mRing;
+        std::vector< std::vector<IndexType> > mRingIndex;
+
+        IndexType clamp(int iOrder, IndexType iIndex);
+        const float* frame(int iOrder, IndexType iIndex);
+    };
+}
+
+#endif /* DELTAS_H */
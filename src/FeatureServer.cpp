@@ -0,0 +1,479 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <cstdio>  // For perror()
+#include <algorithm>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+
+#include "FeatureServer.h"
+#include "PushSink.h"
+
+namespace Tracter
+{
+    /**
+     * A single client connection.  Owns the socket and the driver
+     * for the graph that processes it.
+     */
+    class ServerConnection : public Tracter::Object, public PushHandler
+    {
+    public:
+        ServerConnection(
+            int iFD, ASRFactory* iFactory,
+            const char* iObjectName = "ServerConnection"
+        );
+        virtual ~ServerConnection() throw ();
+        int Descriptor() const { return mFD; }
+        bool Service();
+        unsigned int Events() const;
+        void Frame(IndexType iIndex, const float* iFrame);
+
+    private:
+        int mFD;
+        PushSink* mDriver;
+        int mFrameBytes;
+        bool mInputDone;
+
+        std::vector<char> mReceive;
+        int mNPartial;
+        std::vector<float> mSamples;
+        std::vector<char> mSend;
+        size_t mSent;
+        size_t mMaxPending;
+
+        size_t pending() const { return mSend.size() - mSent; }
+        bool flush();
+    };
+
+    /**
+     * Worker thread; just calls back into the server.
+     */
+    class ServerWorker : public Thread
+    {
+    public:
+        ServerWorker(FeatureServer* iServer) { mServer = iServer; }
+        virtual ~ServerWorker() throw () {}
+        void start() { mServer->work(); }
+
+    private:
+        FeatureServer* mServer;
+    };
+}
+
+
+/**
+ * Constructor.  Builds the graph for this connection and queues the
+ * time stamp header.
+ */
+Tracter::ServerConnection::ServerConnection(
+    int iFD, ASRFactory* iFactory, const char* iObjectName
+)
+{
+    mObjectName = iObjectName;
+    mFD = iFD;
+
+    // The time of the connection is the time of the first sample
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    TimeType time = (TimeType)tv.tv_sec * ONEe9;
+    time += (TimeType)tv.tv_usec * ONEe3;
+
+    // Receive at most one block of the driver at a time
+    int receiveSize = GetEnv("ReceiveSize", 4096);
+    mReceive.resize(receiveSize);
+    mSamples.resize(receiveSize / sizeof(short));
+    mNPartial = 0;
+    mInputDone = false;
+
+    PushSource* source = new PushSource();
+    source->SetTime(time);
+    Component<float>* frontend;
+    try
+    {
+        frontend = iFactory->CreateFrontend(source);
+    }
+    catch (...)
+    {
+        delete source;
+        throw;
+    }
+
+    // From here on, the driver owns the graph
+    mDriver = new PushSink(source, frontend, this);
+    mFrameBytes = mDriver->Frame().size * sizeof(float);
+    Verbose(1, "fd %d: frame size %d\n", mFD, mDriver->Frame().size);
+
+    // A single receive can yield a few frames beyond the limit
+    float period = mDriver->ExactFrameRate().period;
+    SizeType burst = (SizeType)(mSamples.size() / period) + 2;
+    mMaxPending = std::max(GetEnv("SendSize", 16384), mFrameBytes);
+    mSend.reserve(mMaxPending + mFrameBytes * burst);
+    mSent = 0;
+    if (GetEnv("Header", 1))
+    {
+        TimeType ms = time / ONEe6;
+        mSend.insert(mSend.end(), (char*)&ms, (char*)&ms + sizeof(TimeType));
+    }
+}
+
+Tracter::ServerConnection::~ServerConnection() throw ()
+{
+    delete mDriver;
+    if (mFD >= 0)
+        close(mFD);
+    mFD = -1;
+}
+
+/**
+ * Called by a worker thread when the socket is ready.  Sends pending
+ * output, then reads whatever input is available, pushing it through
+ * the graph.
+ *
+ * @returns false if the connection should be closed.
+ */
+bool Tracter::ServerConnection::Service()
+{
+    if (!flush())
+        return false;
+
+    while (!mInputDone && (pending() < mMaxPending))
+    {
+        ssize_t n = recv(
+            mFD, &mReceive[mNPartial], mReceive.size() - mNPartial, 0
+        );
+        if (n > 0)
+        {
+            int nBytes = mNPartial + n;
+            int nSamples = nBytes / sizeof(short);
+            short* s = (short*)&mReceive[0];
+            for (int i=0; i<nSamples; i++)
+                mSamples[i] = (float)s[i] / 32768.0f;
+            mDriver->Push(&mSamples[0], nSamples);
+
+            // Keep the odd byte for next time
+            mNPartial = nBytes - nSamples * sizeof(short);
+            if (mNPartial)
+                mReceive[0] = mReceive[nBytes-1];
+            if (!flush())
+                return false;
+        }
+        else if (n == 0)
+        {
+            Verbose(1, "fd %d: end of stream after %lld frames\n",
+                    mFD, mDriver->Index());
+            mInputDone = true;
+            mDriver->EndOfStream();
+            if (!flush())
+                return false;
+        }
+        else if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+            break;
+        else if (errno != EINTR)
+        {
+            perror(mObjectName);
+            return false;
+        }
+    }
+
+    return !(mDriver->Done() && (pending() == 0));
+}
+
+/**
+ * Queue a frame from the driver for sending.
+ */
+void Tracter::ServerConnection::Frame(IndexType iIndex, const float* iFrame)
+{
+    const char* frame = (const char*)iFrame;
+    mSend.insert(mSend.end(), frame, frame + mFrameBytes);
+}
+
+/**
+ * Send as much pending output as the socket will take.
+ *
+ * @returns false if the other end has gone away.
+ */
+bool Tracter::ServerConnection::flush()
+{
+    while (pending() > 0)
+    {
+        ssize_t n = send(mFD, &mSend[mSent], pending(), MSG_NOSIGNAL);
+        if (n >= 0)
+            mSent += n;
+        else if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+            break;
+        else if ((errno == EPIPE) || (errno == ECONNRESET))
+        {
+            Verbose(1, "fd %d: connection closed by peer\n", mFD);
+            return false;
+        }
+        else if (errno != EINTR)
+        {
+            perror(mObjectName);
+            return false;
+        }
+    }
+
+    // Rewind the buffer when it's empty; the capacity is retained
+    if (pending() == 0)
+    {
+        mSend.clear();
+        mSent = 0;
+    }
+    return true;
+}
+
+/**
+ * The epoll events that should wake this connection next time.
+ */
+unsigned int Tracter::ServerConnection::Events() const
+{
+    unsigned int events = 0;
+    if (!mInputDone && (pending() < mMaxPending))
+        events |= EPOLLIN;
+    if (pending() > 0)
+        events |= EPOLLOUT;
+    return events;
+}
+
+
+/**
+ * Constructor.  The factory is used to build a front-end for each
+ * connection; it is only ever called from the thread running
+ * Serve().
+ */
+Tracter::FeatureServer::FeatureServer(
+    ASRFactory* iFactory, const char* iObjectName
+)
+{
+    mObjectName = iObjectName;
+    assert(iFactory);
+    mFactory = iFactory;
+    mPort = GetEnv("Port", 30000);
+    mNWorkers = GetEnv("NWorkers", 4);
+    mMaxConnections = GetEnv("MaxConnections", 256);
+    mEpollFD = -1;
+    mStop = false;
+    if (mNWorkers < 1)
+        throw Exception("%s: NWorkers must be at least 1", mObjectName);
+}
+
+Tracter::FeatureServer::~FeatureServer() throw ()
+{
+    std::set<ServerConnection*>::iterator c;
+    for (c = mConnection.begin(); c != mConnection.end(); ++c)
+        delete *c;
+    for (int i=0; i<(int)mWorker.size(); i++)
+        delete mWorker[i];
+    if (mEpollFD >= 0)
+        close(mEpollFD);
+}
+
+/**
+ * Run the server.  Blocks until Stop() is called.
+ */
+void Tracter::FeatureServer::Serve()
+{
+    mSocket.Listen(mPort, true, GetEnv("Backlog", 16));
+    mEpollFD = epoll_create(mMaxConnections + 1);
+    if (mEpollFD == -1)
+    {
+        perror(mObjectName);
+        throw Exception("%s: epoll_create() failed", mObjectName);
+    }
+
+    // The listening socket is the one with a null pointer
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = 0;
+    if (epoll_ctl(mEpollFD, EPOLL_CTL_ADD, mSocket.Descriptor(), &ev) == -1)
+    {
+        perror(mObjectName);
+        throw Exception("%s: epoll_ctl() failed", mObjectName);
+    }
+
+    for (int i=0; i<mNWorkers; i++)
+    {
+        mWorker.push_back(new ServerWorker(this));
+        mWorker[i]->Start();
+    }
+    Verbose(1, "listening on port %hu with %d workers\n", mPort, mNWorkers);
+
+    const int cMaxEvents = 64;
+    struct epoll_event events[cMaxEvents];
+    while (!mStop)
+    {
+        // Time out now and then to notice Stop()
+        int n = epoll_wait(mEpollFD, events, cMaxEvents, 500);
+        if (n == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            perror(mObjectName);
+            throw Exception("%s: epoll_wait() failed", mObjectName);
+        }
+        for (int i=0; i<n; i++)
+            if (events[i].data.ptr)
+                dispatch((ServerConnection*)events[i].data.ptr);
+            else
+                accept();
+    }
+
+    // Wake up the workers so they can see the stop flag
+    mMutex.Lock();
+    mCondition.Broadcast();
+    mMutex.Unlock();
+    for (int i=0; i<(int)mWorker.size(); i++)
+        mWorker[i]->Join();
+    Verbose(1, "stopped\n");
+}
+
+/**
+ * Ask Serve() to return.  Only sets a flag, so it's OK to call it
+ * from a signal handler.
+ */
+void Tracter::FeatureServer::Stop()
+{
+    mStop = true;
+}
+
+/**
+ * Accept all pending connections, building a graph for each one.
+ */
+void Tracter::FeatureServer::accept()
+{
+    int fd;
+    while ((fd = mSocket.Accept()) != -1)
+    {
+        if (fcntl(fd, F_SETFL, O_NONBLOCK) == -1)
+        {
+            perror(mObjectName);
+            close(fd);
+            continue;
+        }
+
+        mMutex.Lock();
+        int nConnections = mConnection.size();
+        mMutex.Unlock();
+        if (nConnections >= mMaxConnections)
+        {
+            Verbose(1, "refusing fd %d: %d connections\n", fd, nConnections);
+            close(fd);
+            continue;
+        }
+
+        ServerConnection* c;
+        try
+        {
+            c = new ServerConnection(fd, mFactory);
+        }
+        catch (std::exception& e)
+        {
+            Verbose(1, "refusing fd %d: %s\n", fd, e.what());
+            close(fd);
+            continue;
+        }
+
+        mMutex.Lock();
+        mConnection.insert(c);
+        mMutex.Unlock();
+
+        struct epoll_event ev;
+        ev.events = c->Events() | EPOLLONESHOT;
+        ev.data.ptr = c;
+        if (epoll_ctl(mEpollFD, EPOLL_CTL_ADD, fd, &ev) == -1)
+        {
+            perror(mObjectName);
+            release(c, true);
+            continue;
+        }
+        Verbose(1, "accepted fd %d\n", fd);
+    }
+}
+
+/**
+ * Queue a ready connection for the workers.  The connection is
+ * registered with EPOLLONESHOT, so it can't be queued again until a
+ * worker re-arms it.
+ */
+void Tracter::FeatureServer::dispatch(ServerConnection* iConnection)
+{
+    mMutex.Lock();
+    mQueue.push_back(iConnection);
+    mCondition.Signal();
+    mMutex.Unlock();
+}
+
+/**
+ * Worker thread loop.
+ */
+void Tracter::FeatureServer::work()
+{
+    ServerConnection* c;
+    while ((c = next()))
+    {
+        bool keep = false;
+        try
+        {
+            keep = c->Service();
+        }
+        catch (std::exception& e)
+        {
+            Verbose(1, "fd %d: %s\n", c->Descriptor(), e.what());
+        }
+        release(c, !keep);
+    }
+}
+
+/**
+ * Wait for the next ready connection.
+ *
+ * @returns null when the server is stopping.
+ */
+Tracter::ServerConnection* Tracter::FeatureServer::next()
+{
+    ServerConnection* c = 0;
+    mMutex.Lock();
+    while (!mStop && mQueue.empty())
+        mCondition.Wait(mMutex);
+    if (!mStop)
+    {
+        c = mQueue.front();
+        mQueue.pop_front();
+    }
+    mMutex.Unlock();
+    return c;
+}
+
+/**
+ * Hand a serviced connection back to epoll, or close it.
+ */
+void Tracter::FeatureServer::release(ServerConnection* iConnection, bool iClose)
+{
+    assert(iConnection);
+    if (!iClose)
+    {
+        struct epoll_event ev;
+        ev.events = iConnection->Events() | EPOLLONESHOT;
+        ev.data.ptr = iConnection;
+        if (epoll_ctl(mEpollFD, EPOLL_CTL_MOD,
+                      iConnection->Descriptor(), &ev) == 0)
+            return;
+        perror(mObjectName);
+    }
+
+    Verbose(1, "closing fd %d\n", iConnection->Descriptor());
+    epoll_ctl(mEpollFD, EPOLL_CTL_DEL, iConnection->Descriptor(), 0);
+    mMutex.Lock();
+    mConnection.erase(iConnection);
+    mMutex.Unlock();
+    delete iConnection;
+}
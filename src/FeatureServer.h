@@ -0,0 +1,80 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#ifndef FEATURESERVER_H
+#define FEATURESERVER_H
+
+#include <set>
+#include <deque>
+#include <vector>
+
+#include "TracterObject.h"
+#include "ASRFactory.h"
+#include "SocketTee.h"
+
+namespace Tracter
+{
+    class ServerConnection;
+    class ServerWorker;
+
+    /**
+     * Multi-stream feature server.
+     *
+     * Listens on a TCP port and accepts any number of concurrent
+     * connections.  Each connection gets its own front-end graph,
+     * built by the ASRFactory, and driven by a PushSink with the
+     * audio (16 bit PCM, native byte order) that the client sends.
+     * Feature frames are sent back as they become computable, in the
+     * same format as a SocketSink: an optional time stamp header
+     * followed by raw float frames.  The client signals the end of
+     * the stream by shutting down its side of the connection for
+     * writing.
+     *
+     * Sockets are non-blocking and multiplexed using epoll(); the
+     * actual feature extraction is done by a fixed pool of worker
+     * threads.  A connection is only ever serviced by one worker at a
+     * time, so the graphs need not be thread safe.
+     *
+     * Front-ends that contain variable rate components (gates) or
+     * that need the whole utterance (e.g., static mean normalisation)
+     * cannot be streamed.
+     */
+    class FeatureServer : public Tracter::Object
+    {
+    public:
+        FeatureServer(
+            ASRFactory* iFactory, const char* iObjectName = "FeatureServer"
+        );
+        virtual ~FeatureServer() throw ();
+        void Serve();
+        void Stop();
+
+    private:
+        friend class ServerWorker;
+
+        ASRFactory* mFactory;
+        unsigned short mPort;
+        int mNWorkers;
+        int mMaxConnections;
+        Socket mSocket;
+        int mEpollFD;
+        volatile bool mStop;
+
+        std::vector<ServerWorker*> mWorker;
+        std::set<ServerConnection*> mConnection;
+        std::deque<ServerConnection*> mQueue;
+        Mutex mMutex;
+        Condition mCondition;
+
+        void accept();
+        void dispatch(ServerConnection* iConnection);
+        void work();
+        ServerConnection* next();
+        void release(ServerConnection* iConnection, bool iClose);
+    };
+}
+
+#endif /* FEATURESERVER_H */
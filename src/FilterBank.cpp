@@ -0,0 +1,116 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <cassert>
+
+#include "Kernel.h"
+#include "FilterBank.h"
+
+Tracter::FilterBank::FilterBank()
+{
+    mNInput = 0;
+    mNFilters = 0;
+    mWeight = 0;
+}
+
+Tracter::FilterBank::~FilterBank()
+{
+    Kernel::Free(mWeight);
+}
+
+/**
+ * Pack filters given as a start bin and a vector of weights per
+ * filter.  Filters that would be padded beyond the end of the input
+ * are padded at the front instead.
+ */
+void Tracter::FilterBank::Pack(
+    const std::vector<int>& iBin,
+    const std::vector< std::vector<float> >& iWeight,
+    int iNInput
+)
+{
+    assert(iNInput > 0);
+    assert(iBin.size() >= iWeight.size());
+    mNInput = iNInput;
+    mNFilters = iWeight.size();
+    mStart.resize(mNFilters);
+    mOffset.resize(mNFilters);
+    mLength.resize(mNFilters);
+
+    int size = 0;
+    for (int i=0; i<mNFilters; i++)
+    {
+        int length = iWeight[i].size();
+        int start = iBin[i];
+        assert(start + length <= iNInput);
+        int padded = Kernel::Pad(length);
+        if (padded > iNInput)
+            // Tiny input; can't pad, so can't use the aligned kernel
+            padded = length;
+        if (start + padded > iNInput)
+            start = iNInput - padded;
+        mStart[i] = (length > 0) ? start : 0;
+        mOffset[i] = size;
+        mLength[i] = padded;
+        size += Kernel::Pad(padded);
+    }
+
+    Kernel::Free(mWeight);
+    mWeight = Kernel::Allocate(size);
+    for (int i=0; i<size; i++)
+        mWeight[i] = 0.0f;
+    for (int i=0; i<mNFilters; i++)
+    {
+        int lead = iBin[i] - mStart[i];
+        for (int j=0; j<(int)iWeight[i].size(); j++)
+            mWeight[mOffset[i] + lead + j] = iWeight[i][j];
+    }
+}
+
+/**
+ * Apply the filter bank to one input vector.
+ */
+void Tracter::FilterBank::Apply(const float* iInput, float* oOutput) const
+{
+    assert(iInput);
+    assert(oOutput);
+    for (int i=0; i<mNFilters; i++)
+        oOutput[i] = (mLength[i] == Kernel::Pad(mLength[i]))
+            ? Kernel::DotAligned(mWeight+mOffset[i], iInput+mStart[i],
+                                 mLength[i])
+            : Kernel::Dot(mWeight+mOffset[i], iInput+mStart[i], mLength[i]);
+}
+
+/**
+ * Apply the filter bank to iNFrames input vectors at once, i.e., a
+ * dense matrix of frames times the sparse filter bank matrix.  The
+ * loop is filter by filter so each filter's weights stay in cache
+ * while they are used for every frame.
+ */
+void Tracter::FilterBank::Apply(
+    const float* iInput, float* oOutput, int iNFrames,
+    int iInputStride, int iOutputStride
+) const
+{
+    assert(iInput);
+    assert(oOutput);
+    for (int i=0; i<mNFilters; i++)
+    {
+        const float* weight = mWeight + mOffset[i];
+        const float* input = iInput + mStart[i];
+        int length = mLength[i];
+        if (length == Kernel::Pad(length))
+            for (int f=0; f<iNFrames; f++)
+                oOutput[f*iOutputStride + i] = Kernel::DotAligned(
+                    weight, input + f*iInputStride, length
+                );
+        else
+            for (int f=0; f<iNFrames; f++)
+                oOutput[f*iOutputStride + i] = Kernel::Dot(
+                    weight, input + f*iInputStride, length
+                );
+    }
+}
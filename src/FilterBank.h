@@ -0,0 +1,54 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#ifndef FILTERBANK_H
+#define FILTERBANK_H
+
+#include <vector>
+
+namespace Tracter
+{
+    /**
+     * Packed filter bank.  A bank of filters, each a contiguous run of
+     * weights starting at some input bin, such as the triangles of a
+     * mel filter bank.  The weights are packed into one aligned array
+     * with each filter zero padded to a whole number of SIMD blocks,
+     * so each output is a single aligned dot product.  Padding is
+     * placed so that no filter reads beyond the input.
+     */
+    class FilterBank
+    {
+    public:
+        FilterBank();
+        ~FilterBank();
+
+        void Pack(
+            const std::vector<int>& iBin,
+            const std::vector< std::vector<float> >& iWeight,
+            int iNInput
+        );
+        int NFilters() const { return mNFilters; }
+
+        void Apply(const float* iInput, float* oOutput) const;
+        void Apply(
+            const float* iInput, float* oOutput, int iNFrames,
+            int iInputStride, int iOutputStride
+        ) const;
+
+    private:
+        FilterBank(const FilterBank&);
+        FilterBank& operator =(const FilterBank&);
+
+        int mNInput;
+        int mNFilters;
+        std::vector<int> mStart;   ///< First input bin of each filter
+        std::vector<int> mOffset;  ///< Offset of each filter in mWeight
+        std::vector<int> mLength;  ///< Padded length of each filter
+        float* mWeight;
+    };
+}
+
+#endif /* FILTERBANK_H */
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <cassert>
+
+#include "FourierData.h"
+
+namespace Tracter
+{
+    const StringEnum cFourierBackend[] = {
+        {"Kiss", FOURIER_KISS},
+        {"FFTW", FOURIER_FFTW},
+        {0,      -1}
+    };
+
+    const StringEnum cFourierPlan[] = {
+        {"Estimate", FOURIER_ESTIMATE},
+        {"Measure",  FOURIER_MEASURE},
+        {"Patient",  FOURIER_PATIENT},
+        {0,          -1}
+    };
+}
+
+Tracter::Fourier::~Fourier() throw ()
+{
+    delete mFourierData;
+}
+
+/* C to C */
+void Tracter::Fourier::Init(
+    int iOrder, complex** ioIData, complex** ioOData, bool iInverse
+)
+{
+    create();
+    mFourierData->Init(iOrder, ioIData, ioOData, iInverse);
+}
+
+/* R to C */
+void Tracter::Fourier::Init(
+    int iOrder, float** ioIData, complex** ioOData, int iBatch
+)
+{
+    assert(iBatch > 0);
+    create();
+    mBatch = iBatch;
+    mFourierData->Init(iOrder, ioIData, ioOData, iBatch);
+}
+
+/* C to R */
+void Tracter::Fourier::Init(int iOrder, complex** ioIData, float** ioOData)
+{
+    create();
+    mFourierData->Init(iOrder, ioIData, ioOData);
+}
+
+/* R to R */
+void Tracter::Fourier::Init(int iOrder, float** ioIData, float** ioOData)
+{
+    create();
+    mFourierData->Init(iOrder, ioIData, ioOData);
+}
+
+void Tracter::Fourier::Transform()
+{
+    assert(mFourierData);
+    mFourierData->Transform(mBatch);
+}
+
+void Tracter::Fourier::Transform(int iCount)
+{
+    assert(mFourierData);
+    assert((iCount > 0) && (iCount <= mBatch));
+    mFourierData->Transform(iCount);
+}
+
+/**
+ * Instantiate the implementation chosen by the Backend option.
+ */
+void Tracter::Fourier::create()
+{
+    assert(mFourierData == 0);
+    FourierBackend backend =
+        (FourierBackend)GetEnv(cFourierBackend, FOURIER_KISS);
+
+    switch (backend)
+    {
+    case FOURIER_KISS:
+        mFourierData = NewFourierKiss();
+        break;
+
+    case FOURIER_FFTW:
+#ifdef HAVE_FFTW3
+        mFourierData = NewFourierFFTW(
+            (FourierPlan)GetEnv(cFourierPlan, FOURIER_ESTIMATE),
+            GetEnv("Wisdom", "")
+        );
+        break;
+#else
+        throw Exception("%s: FFTW backend not compiled in", mObjectName);
+#endif
+
+    default:
+        throw Exception("%s: unknown backend %d", mObjectName, backend);
+    }
+}
@@ -10,39 +10,64 @@
 
 #include <complex>
 
+#include "TracterObject.h"
+
 namespace Tracter
 {
     typedef std::complex<float> complex;
 
     /**
-     * Implementation specific data
+     * Implementation specific data; see FourierData.h
      */
-    struct FourierData;
+    class FourierData;
+
+    /** Fourier transform implementations */
+    enum FourierBackend
+    {
+        FOURIER_KISS,
+        FOURIER_FFTW
+    };
+    extern const StringEnum cFourierBackend[];
+
+    /** How hard FFTW should look for a fast plan */
+    enum FourierPlan
+    {
+        FOURIER_ESTIMATE,
+        FOURIER_MEASURE,
+        FOURIER_PATIENT
+    };
+    extern const StringEnum cFourierPlan[];
 
     /*
      * Interface to Fourier transform objects
      *
-     * The general idea is that you choose at compile time which one you
-     * want to use.  IPP, FFTW, Kiss etc.
+     * This is the class that actually gets instantiated.  The
+     * implementation is chosen at run time, when the transform is
+     * initialised, by the enumeration cFourierBackend (Fourier_Kiss=1
+     * or Fourier_FFTW=1, if it was compiled in); the default is Kiss.
+     * The implementation is an instance of a class derived from
+     * FourierData, and is owned by this class.
      *
-     * This is not an interface in the pure virtual sense.  The
-     * implementation is chosen at compile time, not run time, so this is
-     * the class that actually gets instantiated.  To get implementation
-     * specific behaviour, the implementation specific FourierData is
-     * aggregated with a pre-declaration, then declared and allocated in
-     * the implementation's constructors.
+     * The FFTW backend caches plans, so many transforms of the same
+     * size are cheap to set up.  cFourierPlan sets the planning
+     * effort; the default, Estimate, gives the same plan every run.
+     * Measure and Patient time candidate plans, so may give slightly
+     * different numbers from run to run.  Wisdom names a file that
+     * plans are imported from and, for those two, exported to.
      */
-    class Fourier
+    class Fourier : public Tracter::Object
     {
     public:
         /** Default constructor */
         Fourier()
         {
+            mObjectName = "Fourier";
             mFourierData = 0;
+            mBatch = 1;
         }
 
         /** Destructor */
-        virtual ~Fourier();
+        virtual ~Fourier() throw ();
 
         /** Constructor, including initialisation of complex to complex
          * transform */
@@ -51,7 +76,9 @@ namespace Tracter
             bool iInverse=false
         )
         {
+            mObjectName = "Fourier";
             mFourierData = 0;
+            mBatch = 1;
             Init(iOrder, ioIData, ioOData, iInverse);
         }
 
@@ -65,18 +92,29 @@ namespace Tracter
          * transform */
         Fourier(int iOrder, float** ioIData, complex** ioOData)
         {
+            mObjectName = "Fourier";
             mFourierData = 0;
+            mBatch = 1;
             Init(iOrder, ioIData, ioOData);
         }
 
-        /** Initialise a real to complex transform */
-        void Init(int iOrder, float** ioIData, complex** ioOData);
+        /**
+         * Initialise a real to complex transform.  With iBatch > 1,
+         * the arrays hold iBatch frames back to back, iOrder samples
+         * in and iOrder/2+1 bins out per frame, and they are all
+         * transformed by each call to Transform().
+         */
+        void Init(
+            int iOrder, float** ioIData, complex** ioOData, int iBatch=1
+        );
 
         /** Constructor, including initialisation of complex to real
          * transform */
         Fourier(int iOrder, complex** ioIData, float** ioOData)
         {
+            mObjectName = "Fourier";
             mFourierData = 0;
+            mBatch = 1;
             Init(iOrder, ioIData, ioOData);
         }
 
@@ -86,7 +124,9 @@ namespace Tracter
         /** Constructor, including initialisation of real to real transform */
         Fourier(int iOrder, float** ioIData, float** ioOData)
         {
+            mObjectName = "Fourier";
             mFourierData = 0;
+            mBatch = 1;
             Init(iOrder, ioIData, ioOData);
         }
 
@@ -96,9 +136,15 @@ namespace Tracter
         /** Run the actual transform */
         void Transform();
 
+        /** Run the transform on just the first iCount frames of a batch */
+        void Transform(int iCount);
+
     private:
         /** Implementation specific data */
         FourierData* mFourierData;
+        int mBatch;
+
+        void create();
     };
 }
 
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#ifndef FOURIERDATA_H
+#define FOURIERDATA_H
+
+#include "Fourier.h"
+
+namespace Tracter
+{
+    /**
+     * Base class for Fourier transform implementations.
+     *
+     * The Init() calls have the same meaning as those of Fourier.  A
+     * null array pointer means the implementation should allocate
+     * (and later free) the array itself, and pass it back.
+     */
+    class FourierData
+    {
+    public:
+        virtual ~FourierData() {}
+
+        /** Initialise a complex to complex transform */
+        virtual void Init(
+            int iOrder, complex** ioIData, complex** ioOData, bool iInverse
+        ) = 0;
+
+        /** Initialise a batch of real to complex transforms */
+        virtual void Init(
+            int iOrder, float** ioIData, complex** ioOData, int iBatch
+        ) = 0;
+
+        /** Initialise a complex to real transform */
+        virtual void Init(int iOrder, complex** ioIData, float** ioOData) = 0;
+
+        /** Initialise real to real transform (DCT2) */
+        virtual void Init(int iOrder, float** ioIData, float** ioOData) = 0;
+
+        /** Run the actual transform on the first iCount of the batch */
+        virtual void Transform(int iCount) = 0;
+    };
+
+    FourierData* NewFourierKiss();
+#ifdef HAVE_FFTW3
+    FourierData* NewFourierFFTW(FourierPlan iPlan, const char* iWisdom);
+#endif
+}
+
+#endif /* FOURIERDATA_H */
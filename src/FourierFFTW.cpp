@@ -0,0 +1,344 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <cassert>
+#include <map>
+
+#include <fftw3.h>
+
+#include "FourierData.h"
+#include "Thread.h"
+
+namespace Tracter
+{
+    /**
+     * FFTW implementation.
+     *
+     * Plans are created on scratch arrays and kept in a process-wide
+     * cache, keyed on everything that FFTW needs to match when a plan
+     * is re-used with the new-array execute functions.  The caller's
+     * arrays are then transformed in place of the scratch ones.
+     */
+    class FFTWData : public FourierData
+    {
+    public:
+        FFTWData(FourierPlan iPlan, const char* iWisdom);
+        virtual ~FFTWData();
+        void Init(
+            int iOrder, complex** ioIData, complex** ioOData, bool iInverse
+        );
+        void Init(
+            int iOrder, float** ioIData, complex** ioOData, int iBatch
+        );
+        void Init(int iOrder, complex** ioIData, float** ioOData);
+        void Init(int iOrder, float** ioIData, float** ioOData);
+        void Transform(int iCount);
+
+    private:
+        enum Type
+        {
+            REAL_TO_COMPLEX,
+            COMPLEX_TO_REAL,
+            COMPLEX_TO_COMPLEX_FORWARD,
+            COMPLEX_TO_COMPLEX_INVERSE,
+            DCT2
+        };
+
+        /** Everything that distinguishes one plan from another */
+        struct Key
+        {
+            Type type;
+            int order;
+            int batch;
+            bool inPlace;
+            bool unaligned;
+            bool operator <(const Key& iKey) const;
+        };
+
+        static std::map<Key, fftwf_plan> sPlan;
+        static Mutex sMutex;
+        static bool sWisdomRead;
+
+        unsigned int mFlags;
+        const char* mWisdom;
+        Type mType;
+        int mOrder;
+        int mBatch;
+        fftwf_plan mPlan;
+        fftwf_plan mSingle;
+        void* mIData;
+        void* mOData;
+        bool mMyIData;
+        bool mMyOData;
+
+        template<class T> T* allocate(int iSize, T** ioData, bool* oMine);
+        void init(Type iType, int iOrder, int iBatch = 1);
+        fftwf_plan plan(const Key& iKey);
+    };
+}
+
+std::map<Tracter::FFTWData::Key, fftwf_plan> Tracter::FFTWData::sPlan;
+Tracter::Mutex Tracter::FFTWData::sMutex;
+bool Tracter::FFTWData::sWisdomRead = false;
+
+Tracter::FourierData* Tracter::NewFourierFFTW(
+    FourierPlan iPlan, const char* iWisdom
+)
+{
+    return new FFTWData(iPlan, iWisdom);
+}
+
+bool Tracter::FFTWData::Key::operator <(const Key& iKey) const
+{
+    if (type != iKey.type)
+        return type < iKey.type;
+    if (order != iKey.order)
+        return order < iKey.order;
+    if (batch != iKey.batch)
+        return batch < iKey.batch;
+    if (inPlace != iKey.inPlace)
+        return inPlace < iKey.inPlace;
+    return unaligned < iKey.unaligned;
+}
+
+Tracter::FFTWData::FFTWData(FourierPlan iPlan, const char* iWisdom)
+{
+    switch (iPlan)
+    {
+    case FOURIER_ESTIMATE:
+        mFlags = FFTW_ESTIMATE;
+        break;
+    case FOURIER_PATIENT:
+        mFlags = FFTW_PATIENT;
+        break;
+    default:
+        mFlags = FFTW_MEASURE;
+    }
+    mWisdom = (iWisdom && *iWisdom) ? iWisdom : 0;
+    mPlan = 0;
+    mSingle = 0;
+    mIData = 0;
+    mOData = 0;
+    mMyIData = false;
+    mMyOData = false;
+}
+
+Tracter::FFTWData::~FFTWData()
+{
+    // The plan belongs to the cache
+    if (mMyIData)
+        fftwf_free(mIData);
+    if (mMyOData && (mOData != mIData))
+        fftwf_free(mOData);
+}
+
+/**
+ * Either allocate (aligned) space or use the caller supplied space.
+ */
+template<class T>
+T* Tracter::FFTWData::allocate(int iSize, T** ioData, bool* oMine)
+{
+    assert(ioData);
+    if (*ioData)
+        *oMine = false;
+    else
+    {
+        *ioData = (T*)fftwf_malloc(iSize * sizeof(T));
+        assert(*ioData);
+        *oMine = true;
+    }
+    return *ioData;
+}
+
+/* C to C */
+void Tracter::FFTWData::Init(
+    int iOrder, complex** ioIData, complex** ioOData, bool iInverse
+)
+{
+    assert(iOrder > 0);
+    mIData = allocate(iOrder, ioIData, &mMyIData);
+    mOData = allocate(iOrder, ioOData, &mMyOData);
+    init(iInverse ? COMPLEX_TO_COMPLEX_INVERSE : COMPLEX_TO_COMPLEX_FORWARD,
+         iOrder);
+}
+
+/* R to C, which is the only one that can be batched */
+void Tracter::FFTWData::Init(
+    int iOrder, float** ioIData, complex** ioOData, int iBatch
+)
+{
+    assert(iOrder > 0);
+    mIData = allocate(iOrder*iBatch, ioIData, &mMyIData);
+    mOData = allocate((iOrder/2+1)*iBatch, ioOData, &mMyOData);
+    init(REAL_TO_COMPLEX, iOrder, iBatch);
+}
+
+/* C to R */
+void Tracter::FFTWData::Init(int iOrder, complex** ioIData, float** ioOData)
+{
+    assert(iOrder > 0);
+    mIData = allocate(iOrder/2+1, ioIData, &mMyIData);
+    mOData = allocate(iOrder, ioOData, &mMyOData);
+    init(COMPLEX_TO_REAL, iOrder);
+}
+
+/**
+ * Real to real, which is DCT2 (FFTW's REDFT10) for compatibility
+ * with the Kiss implementation.  As there, the input is allocated
+ * twice the order, but only the first half is used.
+ */
+void Tracter::FFTWData::Init(int iOrder, float** ioIData, float** ioOData)
+{
+    assert(iOrder > 0);
+    mIData = allocate(iOrder*2, ioIData, &mMyIData);
+    mOData = allocate(iOrder, ioOData, &mMyOData);
+    init(DCT2, iOrder);
+}
+
+/**
+ * Get the plans for this instance.  A partial batch is done one frame
+ * at a time with a single-frame plan; as the frames after the first
+ * need not be aligned, that plan never assumes alignment.
+ */
+void Tracter::FFTWData::init(Type iType, int iOrder, int iBatch)
+{
+    mType = iType;
+    mOrder = iOrder;
+    mBatch = iBatch;
+
+    Key key;
+    key.type = iType;
+    key.order = iOrder;
+    key.batch = iBatch;
+    key.inPlace = (mIData == mOData);
+    key.unaligned =
+        fftwf_alignment_of((float*)mIData) ||
+        fftwf_alignment_of((float*)mOData);
+    mPlan = plan(key);
+    if (iBatch > 1)
+    {
+        key.batch = 1;
+        key.unaligned = true;
+        mSingle = plan(key);
+    }
+}
+
+/**
+ * Find a plan in the cache, or create it on scratch arrays.  The
+ * FFTW planner is not thread safe, hence the lock.
+ */
+fftwf_plan Tracter::FFTWData::plan(const Key& iKey)
+{
+    sMutex.Lock();
+    std::map<Key, fftwf_plan>::iterator p = sPlan.find(iKey);
+    if (p != sPlan.end())
+    {
+        fftwf_plan plan = p->second;
+        sMutex.Unlock();
+        return plan;
+    }
+
+    if (mWisdom && !sWisdomRead)
+    {
+        fftwf_import_wisdom_from_filename(mWisdom);
+        sWisdomRead = true;
+    }
+
+    // Scratch space big enough for any of the types
+    int n = iKey.order;
+    int size = 2 * (n + 2) * iKey.batch;
+    float* idata = (float*)fftwf_malloc(size * sizeof(float));
+    float* odata = iKey.inPlace
+        ? idata
+        : (float*)fftwf_malloc(size * sizeof(float));
+    unsigned int flags = mFlags;
+    if (iKey.unaligned)
+        flags |= FFTW_UNALIGNED;
+
+    fftwf_plan plan = 0;
+    switch (iKey.type)
+    {
+    case REAL_TO_COMPLEX:
+        plan = fftwf_plan_many_dft_r2c(
+            1, &n, iKey.batch,
+            idata, 0, 1, n,
+            (fftwf_complex*)odata, 0, 1, n/2+1,
+            flags
+        );
+        break;
+    case COMPLEX_TO_REAL:
+        // Kiss leaves the input alone; FFTW wouldn't by default
+        plan = fftwf_plan_dft_c2r_1d(
+            n, (fftwf_complex*)idata, odata, flags | FFTW_PRESERVE_INPUT
+        );
+        break;
+    case COMPLEX_TO_COMPLEX_FORWARD:
+    case COMPLEX_TO_COMPLEX_INVERSE:
+        plan = fftwf_plan_dft_1d(
+            n, (fftwf_complex*)idata, (fftwf_complex*)odata,
+            (iKey.type == COMPLEX_TO_COMPLEX_INVERSE)
+            ? FFTW_BACKWARD : FFTW_FORWARD,
+            flags
+        );
+        break;
+    case DCT2:
+        plan = fftwf_plan_r2r_1d(n, idata, odata, FFTW_REDFT10, flags);
+        break;
+    }
+
+    if (odata != idata)
+        fftwf_free(odata);
+    fftwf_free(idata);
+
+    if (!plan)
+    {
+        sMutex.Unlock();
+        throw Exception("FFTW: failed to plan transform of order %d", n);
+    }
+    sPlan[iKey] = plan;
+    if (mWisdom && (mFlags != FFTW_ESTIMATE))
+        fftwf_export_wisdom_to_filename(mWisdom);
+    sMutex.Unlock();
+    return plan;
+}
+
+/**
+ * Run the cached plan on this instance's arrays.
+ */
+void Tracter::FFTWData::Transform(int iCount)
+{
+    assert(mPlan);
+    switch (mType)
+    {
+    case REAL_TO_COMPLEX:
+        if (iCount == mBatch)
+            fftwf_execute_dft_r2c(
+                mPlan, (float*)mIData, (fftwf_complex*)mOData
+            );
+        else
+            for (int i=0; i<iCount; i++)
+                fftwf_execute_dft_r2c(
+                    mSingle,
+                    (float*)mIData + i*mOrder,
+                    (fftwf_complex*)mOData + i*(mOrder/2+1)
+                );
+        break;
+    case COMPLEX_TO_REAL:
+        fftwf_execute_dft_c2r(
+            mPlan, (fftwf_complex*)mIData, (float*)mOData
+        );
+        break;
+    case COMPLEX_TO_COMPLEX_FORWARD:
+    case COMPLEX_TO_COMPLEX_INVERSE:
+        fftwf_execute_dft(
+            mPlan, (fftwf_complex*)mIData, (fftwf_complex*)mOData
+        );
+        break;
+    case DCT2:
+        fftwf_execute_r2r(mPlan, (float*)mIData, (float*)mOData);
+        break;
+    }
+}
@@ -9,7 +9,7 @@
 
 #include "kiss_fft.h"
 #include "kiss_fftr.h"
-#include "Fourier.h"
+#include "FourierData.h"
 
 namespace FourierKiss
 {
@@ -24,20 +24,42 @@ enum TransformType
     DCT2
 };
 
-/**
- * The class data for FourierKiss
- */
-struct Tracter::FourierData
+namespace Tracter
 {
-    void* IData;
-    void* OData;
-    bool MyIData;
-    bool MyOData;
-    void* Config;
-    TransformType Type;
-    int Order;
-    kiss_fft_cpx* TmpData;
-};
+    /**
+     * The class data for FourierKiss
+     */
+    class KissData : public FourierData
+    {
+    public:
+        KissData();
+        virtual ~KissData();
+        void Init(
+            int iOrder, complex** ioIData, complex** ioOData, bool iInverse
+        );
+        void Init(
+            int iOrder, float** ioIData, complex** ioOData, int iBatch
+        );
+        void Init(int iOrder, complex** ioIData, float** ioOData);
+        void Init(int iOrder, float** ioIData, float** ioOData);
+        void Transform(int iCount);
+
+    private:
+        void* IData;
+        void* OData;
+        bool MyIData;
+        bool MyOData;
+        void* Config;
+        TransformType Type;
+        int Order;
+        kiss_fft_cpx* TmpData;
+    };
+}
+
+Tracter::FourierData* Tracter::NewFourierKiss()
+{
+    return new KissData;
+}
 
 
 /*
@@ -69,8 +91,19 @@ Tl* Allocate(int iSize, Tc** ioCData, void** ioLData, bool* iMyData)
 }
 
 
+Tracter::KissData::KissData()
+{
+    FourierKiss::sInstanceCount++;
+    IData = 0;
+    OData = 0;
+    MyIData = false;
+    MyOData = false;
+    Config = 0;
+    TmpData = 0;
+}
+
 /* C to C */
-void Tracter::Fourier::Init(
+void Tracter::KissData::Init(
     int iOrder, complex** ioIData, complex** ioOData, bool iInverse
 )
 {
@@ -79,116 +112,94 @@ void Tracter::Fourier::Init(
     assert(iOrder > 0);
     assert(sizeof(complex) == sizeof(kiss_fft_cpx));
 
-    FourierKiss::sInstanceCount++;
-
-    assert(mFourierData == 0);
-    mFourierData = new FourierData;
-    FourierData& m = *mFourierData;
-
-    m.Type = COMPLEX_TO_COMPLEX;
+    Type = COMPLEX_TO_COMPLEX;
 
-    Allocate<kiss_fft_cpx, complex>(iOrder, ioIData, &m.IData, &m.MyIData);
-    Allocate<kiss_fft_cpx, complex>(iOrder, ioOData, &m.OData, &m.MyOData);
-    m.TmpData = 0;
+    Allocate<kiss_fft_cpx, complex>(iOrder, ioIData, &IData, &MyIData);
+    Allocate<kiss_fft_cpx, complex>(iOrder, ioOData, &OData, &MyOData);
+    TmpData = 0;
     if (iInverse)
-        m.Config = kiss_fft_alloc(iOrder, 1, 0, 0);
+        Config = kiss_fft_alloc(iOrder, 1, 0, 0);
     else
-        m.Config = kiss_fft_alloc(iOrder, 0, 0, 0);
+        Config = kiss_fft_alloc(iOrder, 0, 0, 0);
 }
 
 
 /**
- * Real to Complex transform
+ * Real to Complex transform.  Kiss has no batch interface, so a batch
+ * is just a loop.
  */
-void Tracter::Fourier::Init(int iOrder, float** ioIData, complex** ioOData)
+void Tracter::KissData::Init(
+    int iOrder, float** ioIData, complex** ioOData, int iBatch
+)
 {
     assert(ioIData);
     assert(ioOData);
     assert(iOrder > 0);
     assert(sizeof(complex) == sizeof(kiss_fft_cpx));
 
-    FourierKiss::sInstanceCount++;
-
-    assert(mFourierData == 0);
-    mFourierData = new FourierData;
-    FourierData& m = *mFourierData;
+    Type = REAL_TO_COMPLEX;
 
-    m.Type = REAL_TO_COMPLEX;
+    Order = iOrder;
 
-    Allocate<float, float>(iOrder, ioIData, &m.IData, &m.MyIData);
-    Allocate<kiss_fft_cpx, complex>(iOrder/2+1, ioOData, &m.OData, &m.MyOData);
-    m.TmpData = 0;
-    m.Config = kiss_fftr_alloc(iOrder, 0, 0, 0);
+    Allocate<float, float>(iOrder*iBatch, ioIData, &IData, &MyIData);
+    Allocate<kiss_fft_cpx, complex>(
+        (iOrder/2+1)*iBatch, ioOData, &OData, &MyOData
+    );
+    TmpData = 0;
+    Config = kiss_fftr_alloc(iOrder, 0, 0, 0);
 }
 
 /**
  * Complex to Real transform
  */
-void Tracter::Fourier::Init(int iOrder, complex** ioIData, float** ioOData)
+void Tracter::KissData::Init(int iOrder, complex** ioIData, float** ioOData)
 {
     assert(ioIData);
     assert(ioOData);
     assert(iOrder > 0);
     assert(sizeof(complex) == sizeof(kiss_fft_cpx));
 
-    FourierKiss::sInstanceCount++;
-
-    assert(mFourierData == 0);
-    mFourierData = new FourierData;
-    FourierData& m = *mFourierData;
-
-    m.Type = COMPLEX_TO_REAL;
+    Type = COMPLEX_TO_REAL;
 
-    Allocate<kiss_fft_cpx, complex>(iOrder/2+1, ioIData, &m.IData, &m.MyIData);
-    Allocate<float, float>(iOrder, ioOData, &m.OData, &m.MyOData);
-    m.TmpData = 0;
-    m.Config = kiss_fftr_alloc(iOrder, 1, 0, 0);
+    Allocate<kiss_fft_cpx, complex>(iOrder/2+1, ioIData, &IData, &MyIData);
+    Allocate<float, float>(iOrder, ioOData, &OData, &MyOData);
+    TmpData = 0;
+    Config = kiss_fftr_alloc(iOrder, 1, 0, 0);
 }
 
 /**
  * Real to Real transform, a.k.a. cosine transform
  * Wired to do DFT2 right now.
  */
-void Tracter::Fourier::Init(int iOrder, float** ioIData, float** ioOData)
+void Tracter::KissData::Init(int iOrder, float** ioIData, float** ioOData)
 {
     assert(ioIData);
     assert(ioOData);
     assert(iOrder > 0);
 
-    FourierKiss::sInstanceCount++;
-
-    assert(mFourierData == 0);
-    mFourierData = new FourierData;
-    FourierData& m = *mFourierData;
+    Type = DCT2;
+    Order = iOrder;
 
-    m.Type = DCT2;
-    m.Order = iOrder;
-
-    Allocate<float, float>(iOrder*2, ioIData, &m.IData, &m.MyIData);
-    Allocate<float, float>(iOrder, ioOData, &m.OData, &m.MyOData);
-    m.TmpData =
+    Allocate<float, float>(iOrder*2, ioIData, &IData, &MyIData);
+    Allocate<float, float>(iOrder, ioOData, &OData, &MyOData);
+    TmpData =
         (kiss_fft_cpx*)KISS_FFT_MALLOC((iOrder+1)*sizeof(kiss_fft_cpx));
-    assert(m.TmpData);
-    m.Config = kiss_fftr_alloc(iOrder*2, 0, 0, 0);
+    assert(TmpData);
+    Config = kiss_fftr_alloc(iOrder*2, 0, 0, 0);
 }
 
-Tracter::Fourier::~Fourier()
+Tracter::KissData::~KissData()
 {
-    if (!mFourierData)
-        return;
-
     assert(FourierKiss::sInstanceCount > 0);
-    FourierData& m = *mFourierData;
-
-    if (m.Config)
-        free(m.Config);
-    if (m.MyIData && m.IData)
-        free(m.IData);
-    if (m.MyOData && m.OData)
-        free(m.OData);
-    if (m.TmpData)
-        free(m.TmpData);
-    delete mFourierData;
+
+    if (Config)
+        free(Config);
+    if (MyIData && IData)
+        free(IData);
+    if (MyOData && OData)
+        free(OData);
+    if (TmpData)
+        free(TmpData);
 
     if (--FourierKiss::sInstanceCount == 0)
         kiss_fft_cleanup();
@@ -198,53 +209,52 @@ Tracter::Fourier::~Fourier()
  * Run the actual transform based on the parameters set up in the
  * constructor.
  */
-void Tracter::Fourier::Transform()
+void Tracter::KissData::Transform(int iCount)
 {
-    assert(mFourierData);
-    FourierData& m = *mFourierData;
-
-    switch (m.Type)
+    switch (Type)
     {
     case DCT2:
     {
         /* Duplicate */
-        float* idata = (float*)m.IData;
-        for (int i=0; i<m.Order; i++)
+        float* idata = (float*)IData;
+        for (int i=0; i<Order; i++)
         {
             /* [1 2 3] -> [1 2 3 3 2 1] */
-            idata[i+m.Order] = idata[m.Order-1-i];
+            idata[i+Order] = idata[Order-1-i];
         }
 
         /* Transform and rotate */
-        kiss_fftr((kiss_fftr_cfg)m.Config, (const float*)m.IData, m.TmpData);
-        float* odata = (float*)m.OData;
-        for (int i=0; i<m.Order; i++)
+        kiss_fftr((kiss_fftr_cfg)Config, (const float*)IData, TmpData);
+        float* odata = (float*)OData;
+        for (int i=0; i<Order; i++)
         {
-            float theta = 2.0f*M_PI*(-0.5f)*i/(2.0f*m.Order);
-            odata[i] = ( m.TmpData[i].r * cos(theta) -
-                         m.TmpData[i].i * sin(theta) );
+            float theta = 2.0f*M_PI*(-0.5f)*i/(2.0f*Order);
+            odata[i] = ( TmpData[i].r * cos(theta) -
+                         TmpData[i].i * sin(theta) );
         }
         break;
     }
 
     case REAL_TO_COMPLEX:
-        kiss_fftr(
-            (kiss_fftr_cfg)m.Config,
-            (const float*)m.IData, (kiss_fft_cpx*)m.OData
-        );
+        for (int i=0; i<iCount; i++)
+            kiss_fftr(
+                (kiss_fftr_cfg)Config,
+                (const float*)IData + i*Order,
+                (kiss_fft_cpx*)OData + i*(Order/2+1)
+            );
         break;
 
     case COMPLEX_TO_REAL:
         kiss_fftri(
-            (kiss_fftr_cfg)m.Config,
-            (const kiss_fft_cpx*)m.IData, (float*)m.OData
+            (kiss_fftr_cfg)Config,
+            (const kiss_fft_cpx*)IData, (float*)OData
         );
         break;
 
     case COMPLEX_TO_COMPLEX:
         kiss_fft(
-            (kiss_fft_cfg)m.Config,
-            (const kiss_fft_cpx*)m.IData, (kiss_fft_cpx*)m.OData
+            (kiss_fft_cfg)Config,
+            (const kiss_fft_cpx*)IData, (kiss_fft_cpx*)OData
         );
         break;
 
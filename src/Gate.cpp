@@ -8,6 +8,7 @@
  */
 
 #include "Gate.h"
+#include "Kernel.h"
 
 Tracter::Gate::Gate(
     Component<float>* iInput,
@@ -18,8 +19,16 @@ Tracter::Gate::Gate(
     mObjectName = iObjectName;
     mFrame.size = iInput->Frame().size;
 
-    Connect(iInput);
-    Connect(iControlInput);
+    assert(iControlInput->Frame().size == 1);
+    mBlock = GetEnv("Block", 8);
+    assert(mBlock > 0);
+    mLazy = GetEnv("Lazy", 1);
+    mMargin = mLazy ? GetEnv("Margin", 0) : 0;
+    assert(mMargin >= 0);
+    Connect(iInput, mBlock);
+    mControlBlock = GetEnv("ControlBlock", 64);
+    assert(mControlBlock > 0);
+    Connect(iControlInput, mControlBlock);
 
     mInput = iInput;
     mControlInput = iControlInput;
@@ -27,6 +36,8 @@ Tracter::Gate::Gate(
     mClosedIndex = -1;
     mIndexZero = 0;
     mRemoved = 0;
+    mInputIndex = 0;
+    mOpenUntil = -1;
     mOpen = false;
     mUpstreamEndOfData = false;
 
@@ -54,62 +65,130 @@ void Tracter::Gate::Reset(bool iPropagate)
     mOpenedIndex = -1;
     mClosedIndex = -1;
     mRemoved = 0;
+    mOpenUntil = -1;
 
     // Propagate reset upstream under these conditions
-    CachedComponent<float>::Reset(
+    bool propagate =
         mUpstreamEndOfData ||  // Always after EOD
         !mSegmenting ||        // If not segmenting
-        !mEnabled              // If disabled
-    );
+        !mEnabled;             // If disabled
+    if (propagate)
+        mInputIndex = 0;
+    CachedComponent<float>::Reset(propagate);
     mUpstreamEndOfData = false;
 }
 
-bool Tracter::Gate::UnaryFetch(IndexType iIndex, float* oData)
+/**
+ * gate() decides the first frame of each run.  Once it is open, the
+ * control input is read ahead for the rest of the run, and the whole
+ * run of input is copied in one go.
+ */
+Tracter::SizeType Tracter::Gate::ContiguousFetch(
+    IndexType iIndex, SizeType iLength, SizeType iOffset
+)
 {
     assert(iIndex >= 0);
-    assert(oData);
 
-    // gate() passes by reference and will update iIndex to the
-    // upstream point of view.
-    if (mEnabled && !gate(iIndex))
+    SizeType done = 0;
+    while (done < iLength)
     {
-        Verbose(2, "gate() returned at Index %ld, ClosedIndex %ld\n",
-                iIndex, mClosedIndex);
-
-        // If all went well, mClosedIndex should be equal to iIndex
-        if ( mSegmenting &&
-             (mClosedIndex >= 0) &&
-             (mClosedIndex < iIndex) )
-            throw Exception("iIndex ahead of silence");
-        assert(
-            (mClosedIndex < 0) ||    /* Failed to find silence */
-            (mClosedIndex >= iIndex) /* Succeeded */
-        );
+        // gate() passes by reference and will update index to the
+        // upstream point of view.
+        IndexType index = iIndex + done;
+        if (mEnabled && !gate(index))
+        {
+            Verbose(2, "gate() returned at Index %ld, ClosedIndex %ld\n",
+                    index, mClosedIndex);
 
-        // Must leave mIndexZero alone until reset so the downstream
-        // components can query time properly
+            // If all went well, mClosedIndex should be equal to index
+            if ( mSegmenting &&
+                 (mClosedIndex >= 0) &&
+                 (mClosedIndex < index) )
+                throw Exception("iIndex ahead of silence");
+            assert(
+                (mClosedIndex < 0) ||    /* Failed to find silence */
+                (mClosedIndex >= index)  /* Succeeded */
+            );
 
-        return false;
-    }
+            // Must leave mIndexZero alone until reset so the downstream
+            // components can query time properly
 
-    // Copy input to output
-    const float* ip = mInput->UnaryRead(iIndex);
-    if (!ip)
-        return false;
-    for (int i=0; i<mFrame.size; i++)
-        oData[i] = ip[i];
+            break;
+        }
 
-    return true;
+        // Copy input to output
+        SizeType len = openRun(index, std::min(iLength - done,
+                                               (SizeType)mBlock));
+        CacheArea inputArea;
+        SizeType got = mInput->Read(inputArea, index, len);
+        mInputIndex = index + got;
+        for (SizeType i=0; i<got; i++)
+        {
+            float* ip = mInput->GetPointer(
+                i < inputArea.len[0]
+                ? inputArea.offset + i : i - inputArea.len[0]
+            );
+            float* op = GetPointer(iOffset + done + i);
+            for (int j=0; j<mFrame.size; j++)
+                op[j] = ip[j];
+        }
+        done += got;
+        if (got < len)
+            break;
+    }
+
+    return done;
 }
 
 /**
- * Advance the index to the next valid frame depending on the control
- * input.  iIndex is from the downstream point of view, but is updated
- * to represent the upstream point of view, which could be larger
- * representing skipped over data.
+ * Given that the gate is open at (upstream) iIndex, returns the number
+ * of frames, up to iLength, for which it stays open.  The frames after
+ * the first need not go through gate() as the state can't change.
+ * Concatenation can move the upstream index within gate(), so then
+ * it's one frame at a time.
  *
- * Returns true if data should be output for the given index.
+ * The control input is searched ControlBlock frames at a time, and
+ * the end of the open run remembered in mOpenUntil, so the search
+ * doesn't depend on how much input is read at once.
+ */
+Tracter::SizeType Tracter::Gate::openRun(IndexType iIndex, SizeType iLength)
+{
+    if (!mEnabled)
+        return iLength;
+    if (mConcatenate || (iLength <= 1))
+        return std::min(iLength, (SizeType)1);
+
+    if (mOpenUntil <= iIndex + 1)
+    {
+        SizeType got;
+        mOpenUntil = iIndex + 1 +
+            findControl(iIndex + 1, mControlBlock, false, got);
+    }
+    return std::min(iLength, (SizeType)(mOpenUntil - iIndex));
+}
+
+/**
+ * Reads up to iLength control frames from iIndex and returns the
+ * offset of the first one that is iValue.  If there is none, the
+ * return value is oGot, the number of frames actually read.
  */
+Tracter::SizeType Tracter::Gate::findControl(
+    IndexType iIndex, SizeType iLength, bool iValue, SizeType& oGot
+)
+{
+    CacheArea controlArea;
+    oGot = mControlInput->Read(controlArea, iIndex, iLength);
+    SizeType len0 = std::min(oGot, controlArea.len[0]);
+    SizeType found = Kernel::FindFlag(
+        mControlInput->GetPointer(controlArea.offset), len0, iValue
+    );
+    if ((found == len0) && (oGot > len0))
+        found += Kernel::FindFlag(
+            mControlInput->GetPointer(0), oGot - len0, iValue
+        );
+    return found;
+}
+
 bool Tracter::Gate::gate(IndexType& iIndex)
 {
     assert(iIndex >= 0);
@@ -194,16 +273,57 @@ bool Tracter::Gate::openGate(IndexType iIndex)
     assert(iIndex >= 0);
     assert(mOpen == false);
 
-    IndexType index = iIndex - 1; // Pre-incremented immediately
-    do
+    // Search a block of control frames at a time
+    IndexType index = iIndex;
+    for (;;)
     {
-        if (!readControl(++index))
+        SizeType got;
+        SizeType found = findControl(index, mControlBlock, true, got);
+        if (!mLazy)
+            prime(index + found);
+        if (found < got)
+        {
+            index += found;
+            mOpen = true;
+            break;
+        }
+        index += got;
+        if (got < mControlBlock)
+        {
+            Verbose(2, "openGate: End Of Data at %ld\n", index);
+            mUpstreamEndOfData = true;
             return false;
+        }
     }
-    while (mOpen == false);
 
+    prime(index);
     assert(mOpen == true);
     mOpenedIndex = index;
     Verbose(2, "openGate: opened at %ld\n", mOpenedIndex);
     return true;
 }
+
+/**
+ * Reads the input up to, but not including, iIndex, where the gate is
+ * about to open.  The frames are read forwards a block at a time and
+ * discarded, so the input needs no more cache than for open frames;
+ * it's just that adaptive components upstream (Mean and so on) see
+ * them.  When lazy, only the last Margin frames are read; otherwise
+ * everything since the last read is.
+ */
+void Tracter::Gate::prime(IndexType iIndex)
+{
+    IndexType index = mInputIndex;
+    if (mLazy)
+        index = std::max(index, iIndex - mMargin);
+    while (index < iIndex)
+    {
+        SizeType len = std::min(iIndex - index, (IndexType)mBlock);
+        CacheArea inputArea;
+        SizeType got = mInput->Read(inputArea, index, len);
+        index += got;
+        if (got < len)
+            break;
+    }
+    mInputIndex = std::max(mInputIndex, index);
+}
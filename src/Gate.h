@@ -18,7 +18,21 @@ namespace Tracter
      * Gate.
      *
      * Allows frames through from input to output depending on a
-     * control input.
+     * control input.  Runs of open frames are read and copied in
+     * blocks of up to Block (default 8) frames.  The control input is
+     * searched for the next open or closed frame ControlBlock (default
+     * 64) frames at a time, so the control is resolved up to that far
+     * ahead of the output; set it smaller to reduce the latency.
+     *
+     * By default the gate is Lazy: the input is only read for open
+     * frames, so the expensive part of a graph is not computed for
+     * silence.  Margin (default 0) frames before each opening can
+     * also be read to give adaptive components upstream (e.g., Mean)
+     * a run-in; components such as Deltas read their own context
+     * anyway.  If Lazy is 0, every input frame is read whether or not
+     * it is passed on, giving the output of the ungated graph.  Both
+     * options change the output, as adaptive components upstream see
+     * different frames.
      */
     class Gate : public CachedComponent<float>
     {
@@ -44,7 +58,9 @@ namespace Tracter
         }
 
     protected:
-        bool UnaryFetch(IndexType iIndex, float* oData);
+        SizeType ContiguousFetch(
+            IndexType iIndex, SizeType iLength, SizeType iOffset
+        );
         virtual void Reset(bool iPropagate);
 
     private:
@@ -55,16 +71,27 @@ namespace Tracter
         bool mSegmenting;
         bool mConcatenate;
         bool mUpstreamEndOfData;
+        bool mLazy;
+        int mBlock;
+        int mMargin;
+        int mControlBlock;
 
         bool mOpen;
         IndexType mOpenedIndex; ///< Last frame at which gate was opened
         IndexType mClosedIndex; ///< Last frame at which gate was closed
         IndexType mIndexZero;   ///< Zero'th frame from upstream POV
         IndexType mRemoved;     ///< Number of unwanted frames removed
+        IndexType mInputIndex;  ///< Next input frame to be read
+        IndexType mOpenUntil;   ///< First frame not known to be open
 
         bool gate(IndexType& iIndex);
+        SizeType openRun(IndexType iIndex, SizeType iLength);
+        SizeType findControl(
+            IndexType iIndex, SizeType iLength, bool iValue, SizeType& oGot
+        );
         bool readControl(IndexType iIndex);
         bool openGate(IndexType iIndex);
+        void prime(IndexType iIndex);
     };
 }
 
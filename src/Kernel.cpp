@@ -0,0 +1,654 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <cassert>
+#include <cstdlib>
+#include <cfloat>
+#include <cmath>
+#include <algorithm>
+
+#ifdef __SSE__
+# include <xmmintrin.h>
+#endif
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
+/*
+ * With gcc or clang on x86, kernels that need more than the build
+ * flags allow are compiled with target attributes and chosen at run
+ * time.
+ */
+#if defined __GNUC__ && (defined __x86_64__ || defined __i386__)
+# define KERNEL_DISPATCH
+# include <immintrin.h>
+# if !defined __clang__ && (__GNUC__ >= 11)
+#  define KERNEL_VNNI
+# endif
+#endif
+
+#include "TracterObject.h"
+#include "Kernel.h"
+
+#ifdef HAVE_BLAS
+// The Fortran interface; there's no standard header for it
+extern "C" void sgemm_(
+    const char* transa, const char* transb,
+    const int* m, const int* n, const int* k,
+    const float* alpha, const float* a, const int* lda,
+    const float* b, const int* ldb,
+    const float* beta, float* c, const int* ldc
+);
+#endif
+
+/**
+ * Allocate iN floats aligned for the kernels.  Throws on failure.
+ */
+float* Tracter::Kernel::Allocate(int iN)
+{
+    assert(iN >= 0);
+    void* data = 0;
+    if (posix_memalign(&data, cAlign, (iN ? iN : 1) * sizeof(float)))
+        throw Exception("Kernel: failed to allocate %d floats", iN);
+    return (float*)data;
+}
+
+void Tracter::Kernel::Free(float* iData)
+{
+    free(iData);
+}
+
+/**
+ * Dot product of two arrays of length iN with no alignment
+ * requirement.
+ */
+float Tracter::Kernel::Dot(const float* iA, const float* iB, int iN)
+{
+    int i = 0;
+    float sum = 0.0f;
+#ifdef __SSE__
+    __m128 acc = _mm_setzero_ps();
+    for (; i<=iN-4; i+=4)
+        acc = _mm_add_ps(
+            acc, _mm_mul_ps(_mm_loadu_ps(iA+i), _mm_loadu_ps(iB+i))
+        );
+    float part[4];
+    _mm_storeu_ps(part, acc);
+    sum = (part[0] + part[1]) + (part[2] + part[3]);
+#endif
+    for (; i<iN; i++)
+        sum += iA[i] * iB[i];
+    return sum;
+}
+
+/**
+ * Dot product where iAligned is aligned to cAlign and iN is a
+ * multiple of cAlignFloats, as given by Allocate() and Pad().  iB
+ * need not be aligned.
+ */
+float Tracter::Kernel::DotAligned(
+    const float* iAligned, const float* iB, int iN
+)
+{
+    assert(((size_t)iAligned & (cAlign-1)) == 0);
+    assert((iN & (cAlignFloats-1)) == 0);
+#ifdef __SSE__
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    int i = 0;
+    for (; i<=iN-8; i+=8)
+    {
+        acc0 = _mm_add_ps(
+            acc0, _mm_mul_ps(_mm_load_ps(iAligned+i), _mm_loadu_ps(iB+i))
+        );
+        acc1 = _mm_add_ps(
+            acc1, _mm_mul_ps(_mm_load_ps(iAligned+i+4), _mm_loadu_ps(iB+i+4))
+        );
+    }
+    if (i < iN)
+        acc0 = _mm_add_ps(
+            acc0, _mm_mul_ps(_mm_load_ps(iAligned+i), _mm_loadu_ps(iB+i))
+        );
+    float part[4];
+    _mm_storeu_ps(part, _mm_add_ps(acc0, acc1));
+    return (part[0] + part[1]) + (part[2] + part[3]);
+#else
+    return Dot(iAligned, iB, iN);
+#endif
+}
+
+namespace Tracter
+{
+    namespace Kernel
+    {
+        typedef int (*DotInt8Function)(
+            const unsigned char* iA, const signed char* iB, int iN
+        );
+
+        int dotInt8(const unsigned char* iA, const signed char* iB, int iN)
+        {
+            int sum = 0;
+            for (int i=0; i<iN; i++)
+                sum += iA[i] * iB[i];
+            return sum;
+        }
+
+#ifdef KERNEL_DISPATCH
+        __attribute__((target("ssse3")))
+        int dotInt8SSSE3(
+            const unsigned char* iA, const signed char* iB, int iN
+        )
+        {
+            int i = 0;
+            const __m128i ones = _mm_set1_epi16(1);
+            __m128i acc = _mm_setzero_si128();
+            for (; i<=iN-16; i+=16)
+            {
+                __m128i p = _mm_maddubs_epi16(
+                    _mm_loadu_si128((const __m128i*)(iA+i)),
+                    _mm_loadu_si128((const __m128i*)(iB+i))
+                );
+                acc = _mm_add_epi32(acc, _mm_madd_epi16(p, ones));
+            }
+            int part[4];
+            _mm_storeu_si128((__m128i*)part, acc);
+            int sum = (part[0] + part[1]) + (part[2] + part[3]);
+            return sum + dotInt8(iA+i, iB+i, iN-i);
+        }
+
+        __attribute__((target("avx2")))
+        int dotInt8AVX2(
+            const unsigned char* iA, const signed char* iB, int iN
+        )
+        {
+            int i = 0;
+            const __m256i ones = _mm256_set1_epi16(1);
+            __m256i acc = _mm256_setzero_si256();
+            for (; i<=iN-32; i+=32)
+            {
+                __m256i p = _mm256_maddubs_epi16(
+                    _mm256_loadu_si256((const __m256i*)(iA+i)),
+                    _mm256_loadu_si256((const __m256i*)(iB+i))
+                );
+                acc = _mm256_add_epi32(acc, _mm256_madd_epi16(p, ones));
+            }
+
+            // The rest stays in this function; calling the SSSE3 (i.e.,
+            // non-VEX) code with the upper halves dirty would be slow
+            __m128i acc128 = _mm_add_epi32(
+                _mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1)
+            );
+            for (; i<=iN-16; i+=16)
+            {
+                __m128i p = _mm_maddubs_epi16(
+                    _mm_loadu_si128((const __m128i*)(iA+i)),
+                    _mm_loadu_si128((const __m128i*)(iB+i))
+                );
+                acc128 = _mm_add_epi32(
+                    acc128, _mm_madd_epi16(p, _mm256_castsi256_si128(ones))
+                );
+            }
+            int part[4];
+            _mm_storeu_si128((__m128i*)part, acc128);
+            int sum = (part[0] + part[1]) + (part[2] + part[3]);
+            for (; i<iN; i++)
+                sum += iA[i] * iB[i];
+            return sum;
+        }
+#endif
+
+#ifdef KERNEL_VNNI
+        /*
+         * VNNI does the multiply and the sum of four products in one
+         * instruction.  AVX-VNNI and AVX-512 VNNI differ only in the
+         * encoding; both are used at 256 bits, and leave the tail to
+         * the AVX2 code.
+         */
+        __attribute__((target("avxvnni")))
+        int dotInt8AVXVNNI(
+            const unsigned char* iA, const signed char* iB, int iN
+        )
+        {
+            // Two accumulators hide the latency of the instruction
+            int i = 0;
+            __m256i acc0 = _mm256_setzero_si256();
+            __m256i acc1 = _mm256_setzero_si256();
+            for (; i<=iN-64; i+=64)
+            {
+                acc0 = _mm256_dpbusd_avx_epi32(
+                    acc0,
+                    _mm256_loadu_si256((const __m256i*)(iA+i)),
+                    _mm256_loadu_si256((const __m256i*)(iB+i))
+                );
+                acc1 = _mm256_dpbusd_avx_epi32(
+                    acc1,
+                    _mm256_loadu_si256((const __m256i*)(iA+i+32)),
+                    _mm256_loadu_si256((const __m256i*)(iB+i+32))
+                );
+            }
+            if (i <= iN-32)
+            {
+                acc0 = _mm256_dpbusd_avx_epi32(
+                    acc0,
+                    _mm256_loadu_si256((const __m256i*)(iA+i)),
+                    _mm256_loadu_si256((const __m256i*)(iB+i))
+                );
+                i += 32;
+            }
+            __m256i acc = _mm256_add_epi32(acc0, acc1);
+            int part[8];
+            _mm256_storeu_si256((__m256i*)part, acc);
+            int sum = ((part[0] + part[1]) + (part[2] + part[3])) +
+                ((part[4] + part[5]) + (part[6] + part[7]));
+            return sum + dotInt8AVX2(iA+i, iB+i, iN-i);
+        }
+
+        __attribute__((target("avx512vnni,avx512vl")))
+        int dotInt8AVX512VNNI(
+            const unsigned char* iA, const signed char* iB, int iN
+        )
+        {
+            // Two accumulators hide the latency of the instruction
+            int i = 0;
+            __m256i acc0 = _mm256_setzero_si256();
+            __m256i acc1 = _mm256_setzero_si256();
+            for (; i<=iN-64; i+=64)
+            {
+                acc0 = _mm256_dpbusd_epi32(
+                    acc0,
+                    _mm256_loadu_si256((const __m256i*)(iA+i)),
+                    _mm256_loadu_si256((const __m256i*)(iB+i))
+                );
+                acc1 = _mm256_dpbusd_epi32(
+                    acc1,
+                    _mm256_loadu_si256((const __m256i*)(iA+i+32)),
+                    _mm256_loadu_si256((const __m256i*)(iB+i+32))
+                );
+            }
+            if (i <= iN-32)
+            {
+                acc0 = _mm256_dpbusd_epi32(
+                    acc0,
+                    _mm256_loadu_si256((const __m256i*)(iA+i)),
+                    _mm256_loadu_si256((const __m256i*)(iB+i))
+                );
+                i += 32;
+            }
+            __m256i acc = _mm256_add_epi32(acc0, acc1);
+            int part[8];
+            _mm256_storeu_si256((__m256i*)part, acc);
+            int sum = ((part[0] + part[1]) + (part[2] + part[3])) +
+                ((part[4] + part[5]) + (part[6] + part[7]));
+            return sum + dotInt8AVX2(iA+i, iB+i, iN-i);
+        }
+#endif
+
+        DotInt8Function selectDotInt8()
+        {
+#ifdef KERNEL_DISPATCH
+            __builtin_cpu_init();
+# ifdef KERNEL_VNNI
+            if (__builtin_cpu_supports("avxvnni"))
+                return dotInt8AVXVNNI;
+            if (__builtin_cpu_supports("avx512vnni") &&
+                __builtin_cpu_supports("avx512vl"))
+                return dotInt8AVX512VNNI;
+# endif
+            if (__builtin_cpu_supports("avx2"))
+                return dotInt8AVX2;
+            if (__builtin_cpu_supports("ssse3"))
+                return dotInt8SSSE3;
+#endif
+            return dotInt8;
+        }
+    }
+}
+
+/**
+ * Dot product of unsigned and signed bytes, accumulated in an int.
+ * Each product pair must fit in a short, which it does if iA is no
+ * more than 127 and iB is in [-127,127].  Uses VNNI (with gcc 11 or
+ * later), AVX2 or SSSE3 if the CPU has them, whatever the build flags.
+ */
+int Tracter::Kernel::DotInt8(
+    const unsigned char* iA, const signed char* iB, int iN
+)
+{
+    static const DotInt8Function dot = selectDotInt8();
+    return dot(iA, iB, iN);
+}
+
+/**
+ * Returns the index of the first of iN flags that is iValue (true
+ * meaning non-zero), or iN if there is none.  With SSE2, 16 flags are
+ * compared at a time and the position found from the movemask.
+ */
+int Tracter::Kernel::FindFlag(const char* iFlag, int iN, bool iValue)
+{
+    int i = 0;
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    for (; i<=iN-16; i+=16)
+    {
+        // Bits are set where the flag is zero, i.e., false
+        __m128i f = _mm_loadu_si128((const __m128i*)(iFlag+i));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(f, zero));
+        if (iValue)
+            mask = ~mask & 0xffff;
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+#endif
+    for (; i<iN; i++)
+        if ((iFlag[i] != 0) == iValue)
+            return i;
+    return iN;
+}
+
+/*
+ * Constants for Log(); the polynomial is that of the cephes logf().
+ */
+namespace Tracter
+{
+    namespace Kernel
+    {
+        const float cSqrtHalf = 0.707106781186547524f;
+        const float cLogP[9] = {
+            7.0376836292E-2f, -1.1514610310E-1f, 1.1676998740E-1f,
+            -1.2420140846E-1f, 1.4249322787E-1f, -1.6668057665E-1f,
+            2.0000714765E-1f, -2.4999993993E-1f, 3.3333331174E-1f
+        };
+        const float cLogQ1 = -2.12194440E-4f;
+        const float cLogQ2 = 0.693359375f;
+    }
+}
+
+/**
+ * Natural log of iN values.  The input is split into exponent and
+ * mantissa and the log of the mantissa found by polynomial, as in
+ * cephes.  Over positive normal input the error is less than 5e-8
+ * where the result is less than 1 in magnitude, and less than one
+ * unit in the last place elsewhere.  Input that is zero, negative
+ * or denormal is treated as FLT_MIN, so callers should apply any
+ * floor first.  The vector and scalar forms give identical results.
+ */
+void Tracter::Kernel::Log(const float* iInput, float* oOutput, int iN)
+{
+    int i = 0;
+#ifdef __SSE2__
+    const __m128 min = _mm_set1_ps(FLT_MIN);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 sqrtHalf = _mm_set1_ps(cSqrtHalf);
+    const __m128i mantMask = _mm_set1_epi32(~0x7f800000);
+    const __m128i halfBits = _mm_set1_epi32(0x3f000000);
+    const __m128i bias = _mm_set1_epi32(126);
+    for (; i<=iN-4; i+=4)
+    {
+        __m128 x = _mm_max_ps(_mm_loadu_ps(iInput+i), min);
+        __m128i bits = _mm_castps_si128(x);
+
+        // x = m * 2^e with m in [0.5, 1)
+        __m128 e = _mm_cvtepi32_ps(
+            _mm_sub_epi32(_mm_srli_epi32(bits, 23), bias)
+        );
+        x = _mm_castsi128_ps(
+            _mm_or_si128(_mm_and_si128(bits, mantMask), halfBits)
+        );
+
+        // If m < sqrt(0.5), use 2m and e-1 instead; then x = m - 1
+        __m128 small = _mm_cmplt_ps(x, sqrtHalf);
+        e = _mm_sub_ps(e, _mm_and_ps(one, small));
+        x = _mm_add_ps(_mm_sub_ps(x, one), _mm_and_ps(x, small));
+
+        __m128 z = _mm_mul_ps(x, x);
+        __m128 y = _mm_set1_ps(cLogP[0]);
+        for (int p=1; p<9; p++)
+            y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(cLogP[p]));
+        y = _mm_mul_ps(_mm_mul_ps(y, x), z);
+        y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(cLogQ1)));
+        y = _mm_sub_ps(y, _mm_mul_ps(z, half));
+        x = _mm_add_ps(x, y);
+        x = _mm_add_ps(x, _mm_mul_ps(e, _mm_set1_ps(cLogQ2)));
+        _mm_storeu_ps(oOutput+i, x);
+    }
+#endif
+    for (; i<iN; i++)
+    {
+        union { float f; unsigned int u; } bits;
+        bits.f = (iInput[i] > FLT_MIN) ? iInput[i] : FLT_MIN;
+        float e = (float)((int)(bits.u >> 23) - 126);
+        bits.u = (bits.u & ~0x7f800000u) | 0x3f000000u;
+        float x = bits.f;
+        if (x < cSqrtHalf)
+        {
+            e -= 1.0f;
+            x = (x - 1.0f) + x;
+        }
+        else
+            x = x - 1.0f;
+
+        float z = x * x;
+        float y = cLogP[0];
+        for (int p=1; p<9; p++)
+            y = y * x + cLogP[p];
+        y = y * x * z;
+        y = y + e * cLogQ1;
+        y = y - z * 0.5f;
+        x = x + y;
+        oOutput[i] = x + e * cLogQ2;
+    }
+}
+
+/*
+ * Constants for Exp(), again from cephes.  The range is such that the
+ * result is neither infinite nor denormal.
+ */
+namespace Tracter
+{
+    namespace Kernel
+    {
+        const float cExpHi = 88.0f;
+        const float cExpLo = -87.3365447505531f;
+        const float cLog2e = 1.44269504088896341f;
+        const float cExpP[6] = {
+            1.9875691500E-4f, 1.3981999507E-3f, 8.3334519073E-3f,
+            4.1665795894E-2f, 1.6666665459E-1f, 5.0000001201E-1f
+        };
+
+        /*
+         * exp(x) = 2^n exp(r), with n the nearest integer to x/log(2)
+         * and r the (small) remainder.  The vector and scalar forms
+         * do exactly the same operations.
+         */
+#ifdef __SSE2__
+        inline __m128 exp(__m128 iX)
+        {
+            const __m128 one = _mm_set1_ps(1.0f);
+            __m128 x = _mm_min_ps(
+                _mm_max_ps(iX, _mm_set1_ps(cExpLo)), _mm_set1_ps(cExpHi)
+            );
+
+            // n = floor(x / log(2) + 0.5)
+            __m128 n = _mm_add_ps(
+                _mm_mul_ps(x, _mm_set1_ps(cLog2e)), _mm_set1_ps(0.5f)
+            );
+            __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(n));
+            n = _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, n), one));
+
+            x = _mm_sub_ps(x, _mm_mul_ps(n, _mm_set1_ps(cLogQ2)));
+            x = _mm_sub_ps(x, _mm_mul_ps(n, _mm_set1_ps(cLogQ1)));
+            __m128 z = _mm_mul_ps(x, x);
+            __m128 y = _mm_set1_ps(cExpP[0]);
+            for (int p=1; p<6; p++)
+                y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(cExpP[p]));
+            y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(y, z), x), one);
+
+            __m128i e = _mm_slli_epi32(
+                _mm_add_epi32(_mm_cvttps_epi32(n), _mm_set1_epi32(127)), 23
+            );
+            return _mm_mul_ps(y, _mm_castsi128_ps(e));
+        }
+#endif
+        inline float exp(float iX)
+        {
+            float x = std::min(std::max(iX, cExpLo), cExpHi);
+            float n = floorf(x * cLog2e + 0.5f);
+            x = x - n * cLogQ2;
+            x = x - n * cLogQ1;
+            float z = x * x;
+            float y = cExpP[0];
+            for (int p=1; p<6; p++)
+                y = y * x + cExpP[p];
+            y = y * z + x + 1.0f;
+
+            union { float f; unsigned int u; } e;
+            e.u = (unsigned int)((int)n + 127) << 23;
+            return y * e.f;
+        }
+    }
+}
+
+/**
+ * Exponential of iN values.  The relative error is a couple of units
+ * in the last place.  Input is clamped to the range where the result
+ * is a normal float, so large negative input gives FLT_MIN rather
+ * than zero.
+ */
+void Tracter::Kernel::Exp(const float* iInput, float* oOutput, int iN)
+{
+    int i = 0;
+#ifdef __SSE2__
+    for (; i<=iN-4; i+=4)
+        _mm_storeu_ps(oOutput+i, exp(_mm_loadu_ps(iInput+i)));
+#endif
+    for (; i<iN; i++)
+        oOutput[i] = exp(iInput[i]);
+}
+
+/**
+ * Add a bias and apply the logistic sigmoid 1 / (1 + exp(-x)) in
+ * place, as for the output of a neural network layer.
+ */
+void Tracter::Kernel::Sigmoid(const float* iBias, float* ioData, int iN)
+{
+    int i = 0;
+#ifdef __SSE2__
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; i<=iN-4; i+=4)
+    {
+        __m128 x = _mm_add_ps(_mm_loadu_ps(ioData+i), _mm_loadu_ps(iBias+i));
+        x = exp(_mm_sub_ps(zero, x));
+        _mm_storeu_ps(ioData+i, _mm_div_ps(one, _mm_add_ps(one, x)));
+    }
+#endif
+    for (; i<iN; i++)
+    {
+        float x = exp(0.0f - (ioData[i] + iBias[i]));
+        ioData[i] = 1.0f / (1.0f + x);
+    }
+}
+
+/**
+ * Add a bias and apply the softmax function in place.  The maximum is
+ * subtracted before the exponential so it can't overflow.
+ */
+void Tracter::Kernel::SoftMax(const float* iBias, float* ioData, int iN)
+{
+    assert(iN > 0);
+    float max = ioData[0] + iBias[0];
+    for (int i=0; i<iN; i++)
+    {
+        ioData[i] += iBias[i];
+        max = std::max(max, ioData[i]);
+    }
+
+    int i = 0;
+#ifdef __SSE2__
+    const __m128 vmax = _mm_set1_ps(max);
+    for (; i<=iN-4; i+=4)
+        _mm_storeu_ps(
+            ioData+i, exp(_mm_sub_ps(_mm_loadu_ps(ioData+i), vmax))
+        );
+#endif
+    for (; i<iN; i++)
+        ioData[i] = exp(ioData[i] - max);
+
+    float sum = 0.0f;
+    for (i=0; i<iN; i++)
+        sum += ioData[i];
+    float scale = 1.0f / sum;
+    for (i=0; i<iN; i++)
+        ioData[i] *= scale;
+}
+
+/**
+ * Multiply iNFrames frames by a matrix: for each frame, the output is
+ * iMatrix (iRows x iCols, row major) times the input.  The frames are
+ * rows of iInput and oOutput with the given strides, so this is a
+ * single matrix-matrix product.
+ */
+void Tracter::Kernel::MatrixMultiply(
+    const float* iMatrix, int iRows, int iCols,
+    const float* iInput, int iInputStride,
+    float* oOutput, int iOutputStride, int iNFrames
+)
+{
+    MatrixMultiply(iMatrix, iRows, iCols, iCols,
+                   iInput, iInputStride, oOutput, iOutputStride, iNFrames,
+                   false);
+}
+
+/**
+ * As MatrixMultiply(), but the matrix rows are iMatrixStride floats
+ * apart, so the matrix may be a block of columns of a wider one.  If
+ * iAccumulate is set the products are added to the output rather than
+ * overwriting it.
+ */
+void Tracter::Kernel::MatrixMultiply(
+    const float* iMatrix, int iRows, int iCols, int iMatrixStride,
+    const float* iInput, int iInputStride,
+    float* oOutput, int iOutputStride, int iNFrames, bool iAccumulate
+)
+{
+    assert(iMatrix);
+    assert(iMatrixStride >= iCols);
+    if (iNFrames <= 0)
+        return;
+#ifdef HAVE_BLAS
+    // In BLAS's column major terms the matrix is stored transposed,
+    // and the frames are columns
+    const float one = 1.0f;
+    const float beta = iAccumulate ? 1.0f : 0.0f;
+    sgemm_("T", "N", &iRows, &iNFrames, &iCols,
+           &one, iMatrix, &iMatrixStride, iInput, &iInputStride,
+           &beta, oOutput, &iOutputStride);
+#else
+    // If the rows are aligned (e.g., the stride is from Pad()), all
+    // but the last few columns can use DotAligned()
+    bool aligned =
+        (((size_t)iMatrix & (cAlign-1)) == 0) &&
+        ((iMatrixStride & (cAlignFloats-1)) == 0);
+    int head = aligned ? iCols & ~(cAlignFloats-1) : 0;
+
+    // Row by row, so each row stays in cache for all the frames
+    for (int r=0; r<iRows; r++)
+    {
+        const float* row = iMatrix + r*iMatrixStride;
+        for (int f=0; f<iNFrames; f++)
+        {
+            const float* input = iInput + f*iInputStride;
+            float dot = head ? DotAligned(row, input, head) : 0.0f;
+            dot += Dot(row + head, input + head, iCols - head);
+            if (iAccumulate)
+                oOutput[f*iOutputStride + r] += dot;
+            else
+                oOutput[f*iOutputStride + r] = dot;
+        }
+    }
+#endif
+}
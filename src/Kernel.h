@@ -0,0 +1,65 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#ifndef KERNEL_H
+#define KERNEL_H
+
+namespace Tracter
+{
+    /**
+     * Low level numerical kernels.  These use SSE where the compiler
+     * allows it (i.e., __SSE__ is defined), otherwise plain C.
+     * MatrixMultiply() uses BLAS if HAVE_BLAS is defined; Log(), Exp()
+     * and the activations need SSE2 for their vector forms.
+     * DotInt8() uses SSSE3, AVX2 or VNNI, chosen at run time on x86.
+     * FindFlag() works on arrays of char (i.e., BoolType) flags.
+     */
+    namespace Kernel
+    {
+        /** Alignment in bytes that the kernels can take advantage of */
+        const int cAlign = 16;
+
+        /** Alignment in floats */
+        const int cAlignFloats = cAlign / sizeof(float);
+
+        /**
+         * Round iN up to a whole number of blocks of iBlock floats;
+         * iBlock must be a power of two
+         */
+        inline int Pad(int iN, int iBlock = cAlignFloats)
+        {
+            return (iN + iBlock - 1) & ~(iBlock - 1);
+        }
+
+        float* Allocate(int iN);
+        void Free(float* iData);
+
+        float Dot(const float* iA, const float* iB, int iN);
+        float DotAligned(const float* iAligned, const float* iB, int iN);
+        int DotInt8(const unsigned char* iA, const signed char* iB, int iN);
+
+        int FindFlag(const char* iFlag, int iN, bool iValue);
+
+        void Log(const float* iInput, float* oOutput, int iN);
+        void Exp(const float* iInput, float* oOutput, int iN);
+
+        void Sigmoid(const float* iBias, float* ioData, int iN);
+        void SoftMax(const float* iBias, float* ioData, int iN);
+
+        void MatrixMultiply(
+            const float* iMatrix, int iRows, int iCols,
+            const float* iInput, int iInputStride,
+            float* oOutput, int iOutputStride, int iNFrames
+        );
+        void MatrixMultiply(
+            const float* iMatrix, int iRows, int iCols, int iMatrixStride,
+            const float* iInput, int iInputStride,
+            float* oOutput, int iOutputStride, int iNFrames, bool iAccumulate
+        );
+    }
+}
+
+#endif /* KERNEL_H */
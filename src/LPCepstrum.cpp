@@ -7,6 +7,7 @@
 
 #include <cmath>
 
+#include "Kernel.h"
 #include "LPCepstrum.h"
 
 Tracter::LPCepstrum::LPCepstrum(
@@ -36,7 +37,18 @@ Tracter::LPCepstrum::LPCepstrum(
     mAlpha1.resize(mOrder);
     mCompressed = 0;
     mAutoCorrelation = 0;
-    mFourier.Init(mNCompressed, &mCompressed, &mAutoCorrelation);
+    if (GetEnv("Table", DCTTable::Cheaper(mNCompressed, mOrder+1)))
+    {
+        std::vector<int> coeff(mOrder+1);
+        for (int i=0; i<=mOrder; i++)
+            coeff[i] = i;
+        mDCT.Init(mNCompressed, coeff);
+        mTableData.resize(mNCompressed + mOrder+1);
+        mCompressed = &mTableData[0];
+        mAutoCorrelation = &mTableData[mNCompressed];
+    }
+    else
+        mFourier.Init(mNCompressed, &mCompressed, &mAutoCorrelation);
 }
 
 bool Tracter::LPCepstrum::UnaryFetch(IndexType iIndex, float* oData)
@@ -54,7 +66,10 @@ bool Tracter::LPCepstrum::UnaryFetch(IndexType iIndex, float* oData)
         mCompressed[i] = powf(p[i], mCompressionPower);
 
     // Do the DCT
-    mFourier.Transform();
+    if (mDCT.Size())
+        mDCT.Transform(mCompressed, mAutoCorrelation);
+    else
+        mFourier.Transform();
 
     // Levinson / Durbin recursion
     // Indexes are C style from 0, but the books use 1
@@ -131,7 +146,10 @@ bool Tracter::LPCepstrum::UnaryFetch(IndexType iIndex, float* oData)
     }
 
     if (mC0)
-        oData[mNCepstra] = logf(std::max(gain, 1e-8f));
+    {
+        gain = std::max(gain, 1e-8f);
+        Kernel::Log(&gain, &oData[mNCepstra], 1);
+    }
 #endif
 
     return true;
@@ -8,13 +8,19 @@
 #ifndef LPCEPSTRUM_H
 #define LPCEPSTRUM_H
 
+#include <vector>
+
 #include "Fourier.h"
+#include "DCTTable.h"
 #include "CachedComponent.h"
 
 namespace Tracter
 {
     /**
-     * LPCepstrum analysis from a warped spectrum
+     * LPCepstrum analysis from a warped spectrum.  Only Order+1
+     * autocorrelation coefficients are needed, so for small sizes (or
+     * if Table is set) they come from a DCTTable rather than a
+     * Fourier transform.
      */
     class LPCepstrum : public CachedComponent<float>
     {
@@ -38,6 +44,8 @@ namespace Tracter
         float* mCompressed;
         float* mAutoCorrelation;
         Fourier mFourier;
+        DCTTable mDCT;
+        std::vector<float> mTableData;
         std::vector<float> mAlpha0;
         std::vector<float> mAlpha1;
 
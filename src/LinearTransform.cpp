@@ -4,9 +4,9 @@
  * See the file COPYING for the licence associated with this software.
  */
 
-#include <cstdio>
-#include <cstring>
+#include <algorithm>
 
+#include "Kernel.h"
 #include "LinearTransform.h"
 
 Tracter::LinearTransform::LinearTransform(
@@ -15,68 +15,50 @@ Tracter::LinearTransform::LinearTransform(
 {
     mObjectName = iObjectName;
     mInput = iInput;
-    Connect(mInput);
+    mBlock = GetEnv("Block", 8);
+    assert(mBlock > 0);
+    Connect(mInput, mBlock);
 
     const char* file = GetEnv("XFormFile", (const char*)0);
-    mFrame.size = LoadXForm(file);
-    if (mFrame.size * mInput->Frame().size != (int)mMatrix.size())
+    mXForm.Load(file);
+    mFrame.size = mXForm.Rows();
+    if (mInput->Frame().size != mXForm.Cols())
         throw Exception("input dimension %d incompatible with matrix cols %d",
-                        mInput->Frame().size, (int)mMatrix.size()/mFrame.size);
+                        mInput->Frame().size, mXForm.Cols());
 }
 
-bool Tracter::LinearTransform::UnaryFetch(IndexType iIndex, float* oData)
+Tracter::SizeType Tracter::LinearTransform::ContiguousFetch(
+    IndexType iIndex, SizeType iLength, SizeType iOffset
+)
 {
     assert(iIndex >= 0);
-    assert(mMatrix.size() > 0);
-
-    // Read the input frame
-    const float* p = mInput->UnaryRead(iIndex);
-    if (!p)
-        return false;
-
-    /* Multiply, with due disregard to cache and BLAS */
     int nCols = mInput->Frame().size;
-    for (int r=0; r<mFrame.size; r++)
-    {
-        oData[r] = 0.0f;
-        for (int c=0; c<nCols; c++)
-            oData[r] += mMatrix[r*nCols + c] * p[c];
-    }
-
-    return true;
-}
-
-int Tracter::LinearTransform::LoadXForm(const char* iFileName)
-{
-    if (!iFileName)
-        throw Exception("Null file name");
 
-    FILE* fp = fopen(iFileName, "r");
-    if (!fp)
-        throw Exception("Failed to open file %s", iFileName);
-
-    /* Read until the <XForm> tag */
-    char tmpStr[1024] = "";
-    do
+    SizeType done = 0;
+    while (done < iLength)
     {
-        if (fscanf(fp, "%s", tmpStr) != 1)
-            throw Exception("Failed to read <XForm> token");
-    }
-    while (strncasecmp(tmpStr, "<Xform>", 1024));
+        CacheArea inputArea;
+        SizeType len = std::min(iLength - done, (SizeType)mBlock);
+        SizeType got = mInput->Read(inputArea, iIndex + done, len);
 
-    /* Read the row and column dimensions */
-    int nRow, nCol;
-    if (fscanf(fp, "%d %d", &nRow, &nCol) != 2)
-        throw Exception("Failed to read size tokens");
+        // The input may wrap around its cache
+        float* output = GetPointer(iOffset + done);
+        Kernel::MatrixMultiply(
+            mXForm.Data(), mFrame.size, nCols,
+            mInput->GetPointer(inputArea.offset), nCols,
+            output, mFrame.size, inputArea.len[0]
+        );
+        Kernel::MatrixMultiply(
+            mXForm.Data(), mFrame.size, nCols,
+            mInput->GetPointer(0), nCols,
+            output + inputArea.len[0] * mFrame.size, mFrame.size,
+            inputArea.len[1]
+        );
 
-    /* And finally the matrix itself */
-    int size = nRow * nCol;
-    mMatrix.resize(size);
-    for (int i=0; i<size; i++)
-        if (fscanf(fp, "%f", &mMatrix[i]) != 1)
-            throw Exception("failed to read element %d", i);
+        done += got;
+        if (got < len)
+            break;
+    }
 
-    /* Done */
-    fclose(fp);
-    return nRow;
+    return done;
 }
@@ -7,11 +7,17 @@
 #ifndef LINEARTRANSFORM_H
 #define LINEARTRANSFORM_H
 
-#include <vector>
 #include "CachedComponent.h"
+#include "XForm.h"
 
 namespace Tracter
 {
+    /**
+     * Multiplies each frame by a matrix read from XFormFile, which may
+     * be text or binary (see XForm).  When the downstream component
+     * asks for several frames at once, up to Block frames are done in
+     * one matrix-matrix product.
+     */
     class LinearTransform : public CachedComponent<float>
     {
     public:
@@ -20,12 +26,14 @@ namespace Tracter
         virtual ~LinearTransform() throw() {}
 
     protected:
-        bool UnaryFetch(IndexType iIndex, float* oData);
-        int LoadXForm(const char* iFileName);
+        SizeType ContiguousFetch(
+            IndexType iIndex, SizeType iLength, SizeType iOffset
+        );
 
     private:
         Component<float>* mInput;
-        std::vector<float> mMatrix;
+        int mBlock;
+        XForm mXForm;
     };
 }
 
@@ -8,6 +8,7 @@
 #include <cstdio>
 #include <cmath>
 
+#include "Kernel.h"
 #include "Log.h"
 
 /**
@@ -41,15 +42,16 @@ bool Tracter::Log::UnaryFetch(IndexType iIndex, float* oData)
     if (!ip)
         return false;
 
-    // Copy the frame though a log function
+    // Copy the frame though a floor and a log function
     for (int i=0; i<mFrame.size; i++)
         if (ip[i] > mFloor)
-            oData[i] = logf(ip[i]);
+            oData[i] = ip[i];
         else
         {
-            oData[i] = mLogFloor;
+            oData[i] = mFloor;
             mFloored++;
         }
+    Kernel::Log(oData, oData, mFrame.size);
 
     // Done
     return true;
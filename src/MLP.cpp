@@ -5,10 +5,13 @@
  * See the file COPYING for the licence associated with this software.
  */
 
+#include <algorithm>
+#include <cstring>
+
 #include "MLP.h"
-#include "DiskXFile.h"
 
 Tracter::MLP::MLP(Component<float>* iInput, const char* iObjectName)
+    : mNet(iObjectName)
 {
     mObjectName = iObjectName;
     mInput = iInput;
@@ -18,94 +21,75 @@ Tracter::MLP::MLP(Component<float>* iInput, const char* iObjectName)
 
     mTheta = GetEnv("Theta", 9);
     assert(mTheta > 0);
+    mBlock = GetEnv("Block", 16);
+    assert(mBlock > 0);
 
     const char *fname = GetEnv("Weights", "");
-    assert(strlen(fname) > 0);
-
-    Torch::DiskXFile xfile(fname,"rb");
-    mMLP.loadXFile(&xfile);
-    //mMLP.build();
-    if (mMLP.machine_infos[mMLP.n_layers-1][0]->desc == Torch::LOGSOFTMAX){
-        Torch::SoftMax *sm = new Torch::SoftMax(mMLP.n_outputs);
-        mMLP.removeFCL();
-        mMLP.addFCL(sm);
-    }
-    mMLP.build();
-    mMLP.setPartialBackprop();
+    if (strlen(fname) == 0)
+        throw Exception("%s: Weights must be set", mObjectName);
+    mNet.Load(fname);
+    if (GetEnv("Quantise", 0))
+        mNet.Quantise();
 
     mWindow = mTheta*2 + 1;
-    mFeature.resize(mMLP.n_inputs);
-    if (mMLP.n_inputs != mWindow*mInputs)
+    if (mNet.Inputs() != mWindow*mInputs)
         throw Exception("MLP: Dimension mismatch: %d != %d",
-                        mMLP.n_inputs, mWindow*mInputs);
-    Connect(mInput, mWindow, mTheta);
+                        mNet.Inputs(), mWindow*mInputs);
+    mFeature.resize((mBlock - 1 + mWindow) * mInputs);
+    Connect(mInput, mBlock - 1 + mWindow, mBlock - 1 + mTheta);
 
-    mFrame.size = mMLP.n_outputs;
+    mFrame.size = mNet.Outputs();
     assert(mFrame.size > 0);
 }
 
 /*
- * This is the calculation for one frame.  Pretty trivial, but the
- * edge effects make the code quite long.
+ * Each block of frames is read in one go, including the context, and
+ * copied once into a contiguous buffer with the frames at the edges
+ * duplicated.  The network then runs directly on the overlapping
+ * windows of that buffer.
  */
-bool Tracter::MLP::UnaryFetch(IndexType iIndex, float* oData)
+Tracter::SizeType Tracter::MLP::ContiguousFetch(
+    IndexType iIndex, SizeType iLength, SizeType iOffset
+)
 {
     assert(iIndex >= 0);
-    CacheArea inputArea;
 
-    // Decide how many frames to request depending on whether need to
-    // take into account the edge-effect at the beginning.
-    int wanted;
-    int readIndex;
-    if (iIndex < mTheta)
+    SizeType done = 0;
+    while (done < iLength)
     {
-        wanted = mWindow - (mTheta - iIndex);
-        readIndex = 0;
-    }else{
-        wanted = mWindow;
-        readIndex = iIndex - mTheta;
-    }
-    int lenGot = mInput->Read(inputArea, readIndex, wanted);
-    if (lenGot < mTheta+1)
-        return false;
+        // Read the block with its context, which may be truncated at
+        // either end
+        IndexType index = iIndex + done;
+        IndexType first = std::max(index - mTheta, (IndexType)0);
+        SizeType len = std::min(iLength - done, (SizeType)mBlock);
+        CacheArea inputArea;
+        SizeType wanted = index + len + mTheta - first;
+        SizeType got = mInput->Read(inputArea, first, wanted);
+        SizeType nOut = std::min(len, (SizeType)(first + got - index));
+        if (nOut <= 0)
+            break;
 
-    // To handle the edges, duplicate frames at the edges
-    int feature = 0;
-    int offset = inputArea.offset;
-    for (int i=0; i<mWindow-wanted; i++)
-    {
-        float* p = mInput->GetPointer(offset);
-        for (int j=0; j<mInputs ; j++, p++){
-            mFeature[feature++] = *p;
+        float* feature = &mFeature[0];
+        for (SizeType j=-mTheta; j<nOut+mTheta; j++)
+        {
+            IndexType i = std::min(std::max(index + j, first),
+                                   first + got - 1) - first;
+            float* p = mInput->GetPointer(
+                i < inputArea.len[0]
+                ? inputArea.offset + i : i - inputArea.len[0]
+            );
+            for (int d=0; d<mInputs; d++)
+                *feature++ = p[d];
         }
-    }
 
-    // Copy pointers as if no edge effect
-    for (int i=0; i<lenGot; i++)
-    {
-        if (i == inputArea.len[0])
-            offset = 0;
-        float* p = mInput->GetPointer(offset++);
-        for (int j=0; j<mInputs ; j++, p++){
-          mFeature[feature++] = *p;
-        }
-    }
+        // The actual calculation
+        mNet.ForwardWindow(&mFeature[0], mWindow,
+                           GetPointer(iOffset + done), mFrame.size, nOut);
 
-    // If we got frames back, but fewer than required, then we need to
-    // consider the edge-effect at the end.
-    int lastFeature = feature-mInputs;
-    for (int i=0; i<wanted-lenGot; i++)
-    {
-        float* p =  &(mFeature[lastFeature]);
-        for (int j=0; j<mInputs ; j++, p++){
-            mFeature[feature++] = *p;
-        }
+        done += nOut;
+        if (nOut < len)
+            break;
     }
-    assert(feature == mWindow*mInputs);
-
-    // The actual calculation
-    //printf("runnng MLP on data frame %i\n",iIndex);
-    mMLP.frameForward((int)iIndex,&(mFeature[0]), oData);
 
-    return true;
+    return done;
 }
@@ -11,12 +11,22 @@
 #include <vector>
 
 #include "CachedComponent.h"
-#include "SKMLP.h"
+#include "NeuralNet.h"
 
 namespace Tracter
 {
     /**
-     * Torch based MLP
+     * Multi-layer perceptron
+     *
+     * The input to the network is a window of 2*Theta+1 frames, with
+     * the frames at the edges duplicated.  Weights are read from a
+     * Torch3 file.  Up to Block frames are evaluated at once, with the
+     * first layer accumulated over the window offsets so that the
+     * context windows are never copied out.  If Quantise is set the
+     * network runs with 8 bit weights and activations; mlpcheck shows
+     * how much that changes the outputs.  That is only faster on
+     * CPUs with SSSE3, AVX2 or VNNI; elsewhere it is slower than
+     * float.
      */
     class MLP : public CachedComponent<float>
     {
@@ -25,7 +35,9 @@ namespace Tracter
         virtual ~MLP() throw() {}
 
     protected:
-        bool UnaryFetch(IndexType iIndex, float* oData);
+        SizeType ContiguousFetch(
+            IndexType iIndex, SizeType iLength, SizeType iOffset
+        );
 
         void DotHook()
         {
@@ -38,8 +50,9 @@ namespace Tracter
         int mTheta;
         int mWindow;
         int mInputs;
+        int mBlock;
         std::vector<float> mFeature;
-        Torch::SKMLP mMLP;
+        NeuralNet mNet;
     };
 }
 
@@ -6,6 +6,7 @@
  */
 
 #include <cstdio>
+#include <algorithm>
 
 #include "MLPVAD.h"
 
@@ -38,6 +39,7 @@ Tracter::MLPVAD::MLPVAD(Component<float>* iInput, const char* iObjectName)
     int max = std::max(mConfirmSpeechTime, mConfirmSilenceTime);
     MinSize(mInput, mLookAhead+1,  mLookAhead+max);
     mIndex = -1;
+    mDecision.resize(mLookAhead+1);
 
     Verbose(1, "%s: LookAhead=%d ConfirmSpeech=%d ConfirmSilence=%d\n",
             mObjectName, mLookAhead,
@@ -51,31 +53,41 @@ void Tracter::MLPVAD::Reset(bool iPropagate)
     VADStateMachine::Reset(iPropagate);
 }
 
-bool Tracter::MLPVAD::UnaryFetch(IndexType iIndex, VADState* oData)
+/**
+ * Reads the input in runs of up to LookAhead+1 frames, as that's what
+ * the input is sized for, and runs the state machine over each run.
+ */
+Tracter::SizeType Tracter::MLPVAD::ContiguousFetch(
+    IndexType iIndex, SizeType iLength, SizeType iOffset
+)
 {
     Verbose(3, "iIndex %lld\n", iIndex);
-    //printf("%i %i\n",iIndex, mIndex);
     assert(iIndex == mIndex+1);
-    mIndex = iIndex;
-    CacheArea inputArea;
 
-    /* Current value */
-    int ret_val = mInput->Read(inputArea, iIndex);
-//    if (inputArea.forceDecode)
-//    {
-//    	ConfirmSilence();
-//    	return true;
-//    }
-    if (ret_val == 0) return false;
-    float prob = mInput->GetPointer(inputArea.offset)[mInputIndex];
+    SizeType done = 0;
+    while (done < iLength)
+    {
+        CacheArea inputArea;
+        SizeType len = std::min(iLength - done, (SizeType)mDecision.size());
+        SizeType got = mInput->Read(inputArea, iIndex + done, len);
+        for (SizeType i=0; i<got; i++)
+        {
+            float prob = mInput->GetPointer(
+                i < inputArea.len[0]
+                ? inputArea.offset + i : i - inputArea.len[0]
+            )[mInputIndex];
+            mDecision[i] = mSpeech ? prob > mThreshold : prob < mThreshold;
+            if (mShowGuts)
+                printf("%lld %e\n", iIndex + done + i, prob);
+        }
 
-    /* Update the state machine */
-    Update( mSpeech
-            ? prob >  mThreshold
-            : prob <  mThreshold );
-    *oData = mState;
+        /* Update the state machine */
+        Update(&mDecision[0], GetPointer(iOffset + done), got);
+        done += got;
+        if (got < len)
+            break;
+    }
 
-    if (mShowGuts)
-        printf("%lld %e\n", iIndex, prob);
-    return true;
+    mIndex = iIndex + done - 1;
+    return done;
 }
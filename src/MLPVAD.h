@@ -8,6 +8,8 @@
 #ifndef MLPVAD_H
 #define MLPVAD_H
 
+#include <vector>
+
 #include "VADStateMachine.h"
 
 namespace Tracter
@@ -17,9 +19,12 @@ namespace Tracter
     public:
         MLPVAD(Component<float>* iInput,
                const char* iObjectName = "MLPVAD");
+        virtual ~MLPVAD() throw () {}
 
     protected:
-        bool UnaryFetch(IndexType iIndex, VADState* oData);
+        SizeType ContiguousFetch(
+            IndexType iIndex, SizeType iLength, SizeType iOffset
+        );
         virtual void Reset(bool iPropagate);
 
     private:
@@ -31,6 +36,7 @@ namespace Tracter
 
         int mLookAhead;
         bool mShowGuts;
+        std::vector<BoolType> mDecision;
     };
 }
 
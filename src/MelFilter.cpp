@@ -7,6 +7,7 @@
 
 #include <cstdio>
 #include <cmath>
+#include <algorithm>
 
 #include "MelFilter.h"
 
@@ -41,7 +42,9 @@ Tracter::MelFilter::MelFilter(
 {
     mObjectName = iObjectName;
     mInput = iInput;
-    Connect(mInput);
+    mBlock = GetEnv("Block", 8);
+    assert(mBlock > 0);
+    Connect(mInput, mBlock);
 
     mMaxHertz = GetEnv("MaxHertz", 4000.0f);
     mFrame.size = GetEnv("NBins", 23);
@@ -61,28 +64,41 @@ Tracter::MelFilter::MelFilter(
 
     if (GetEnv("Normalise", 0))
         normaliseBins();
+
+    mFilterBank.Pack(mBin, mWeight, mInput->Frame().size);
 }
 
-bool Tracter::MelFilter::UnaryFetch(IndexType iIndex, float* oData)
+Tracter::SizeType Tracter::MelFilter::ContiguousFetch(
+    IndexType iIndex, SizeType iLength, SizeType iOffset
+)
 {
     assert(iIndex >= 0);
-    assert(oData);
-
-    CacheArea inputArea;
-    int one = mInput->Read(inputArea, iIndex);
-    if (!one)
-        return false;
+    int inputSize = mInput->Frame().size;
 
-    float* p = mInput->GetPointer(inputArea.offset);
-    for (int i=0; i<mFrame.size; i++)
+    SizeType done = 0;
+    while (done < iLength)
     {
-        //assert(mBin[i+2]-mBin[i]+1 == mWeight[i].size());
-        oData[i] = 0.0f;
-        for (size_t j=0; j<mWeight[i].size(); j++)
-            oData[i] += mWeight[i][j] * p[mBin[i]+j];
+        CacheArea inputArea;
+        SizeType len = std::min(iLength - done, (SizeType)mBlock);
+        SizeType got = mInput->Read(inputArea, iIndex + done, len);
+
+        // The input may wrap around its cache
+        float* output = GetPointer(iOffset + done);
+        mFilterBank.Apply(
+            mInput->GetPointer(inputArea.offset), output,
+            inputArea.len[0], inputSize, mFrame.size
+        );
+        mFilterBank.Apply(
+            mInput->GetPointer(0), output + inputArea.len[0] * mFrame.size,
+            inputArea.len[1], inputSize, mFrame.size
+        );
+
+        done += got;
+        if (got < len)
+            break;
     }
 
-    return true;
+    return done;
 }
 
 /**
@@ -11,11 +11,14 @@
 #include <vector>
 
 #include "CachedComponent.h"
+#include "FilterBank.h"
 
 namespace Tracter
 {
     /**
-     * Mel scaled filter bank.
+     * Mel scaled filter bank.  When the downstream component asks for
+     * several frames at once, up to Block frames are filtered in one
+     * pass over the packed filter bank.
      */
     class MelFilter : public CachedComponent<float>
     {
@@ -27,10 +30,14 @@ namespace Tracter
         void DumpBins();
 
     protected:
-        bool UnaryFetch(IndexType iIndex, float* oData);
+        SizeType ContiguousFetch(
+            IndexType iIndex, SizeType iLength, SizeType iOffset
+        );
 
     private:
         Component<float>* mInput;
+        int mBlock;
+        FilterBank mFilterBank;
 
         std::vector<int> mBin;   // Mel 'centers' in terms of DFT bins
         std::vector< std::vector<float> > mWeight; // The actual filters
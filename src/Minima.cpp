@@ -7,225 +7,11 @@
 
 #include <limits>
 
-#include "Minima.h"
-
-Tracter::SlidingWindow::SlidingWindow(int windowSize, int windowOffset)
-    : windowSize(windowSize)
-{
-    dataSize = std::numeric_limits<IndexType>::max();
-    setWindowOffset(windowOffset);
-}
-
-void Tracter::SlidingWindow::setWindowOffset(int windowOffset) {
-    this->windowOffset = windowOffset;
-}
-
-void Tracter::SlidingWindow::reset() {
-    dataSize = std::numeric_limits<IndexType>::max();
-    setWindowOffset(-windowSize);
-}
-
-void Tracter::SlidingWindow::dump(FILE *out) {
-    fprintf(out, "windowOffset %lld [", windowOffset);
-    const char *sep = "";
-    const IndexType windowStart = windowOffset > 0 ? windowOffset : 0;
-    const IndexType windowEnd = windowOffset + windowSize > dataSize ? dataSize : windowOffset + windowSize;
-    for(IndexType index = windowStart; index<windowEnd; index++) {
-        fprintf(out, "%s%g", sep, get(index));
-        sep = ",";
-    }
-    fprintf(out, "]");
-}
-
-
-Tracter::MinimaWindow::MinimaWindow(
-    int window, int nMins
-):
-    SlidingWindow(window, 0),
-    mins(new IndexType[nMins]),
-    minsSize(nMins)
-{
-    reset();
-}
-
-Tracter::MinimaWindow::~MinimaWindow()
-{
-    delete [] mins;
-}
-
-void Tracter::MinimaWindow::reset()
-{
-    SlidingWindow::reset();
-    minCount    = 0;
-    minSum      = 0.0;
-    maxIndex    = -1;
-}
-
-void Tracter::MinimaWindow::shrinkLeft()
-{
-    if(minCount == 0 || windowOffset <= mins[0]) return;    // nothing to do (80%)
-    minCount--;
-    minSum -= get(mins[0]);
-    for(int i = 0; i<minCount; i++) {           // remove mins 0, by shuffling others left...
-        mins[i] = mins[i+1];
-    }
-    if(--maxIndex < 0) determineMaximum();          // lost maximum, re-determine (20% => 4%)
-}
-
-void Tracter::MinimaWindow::growRight()
-{
-    const IndexType   index   = windowOffset + windowSize - 1;
-
-//    if (mDataIndex == 16)
-//    {
-//        printf("growRight: %d %e %e %ld\n", index, maxValue, minSum, dataSize);
-//    }
-
-    if(index >= dataSize)
-    {
-        // If mins were shifted out, we need to re-scan
-        if (minCount < minsSize)
-            scanMinimum();
-        return;
-    }
-                                            //  %
-    const float  sample  = get(index);                              //  100
-
-    if(minCount < minsSize) {               // room for a little one (20%)      //  100
-        if(maxIndex == -1 || sample <= maxValue) {  // small, so add on end (20% => 4%) //   20
-            if(maxIndex == -1 || sample == maxValue) {
-                maxIndex = minCount;
-                maxValue = sample;
-            }
-            mins[minCount++] = index;                           //    4
-            minSum += sample;                               //    4
-        } else {                    // big, look for new minimum (80% => 16%)
-            scanMinimum();                                  //   16
-        }
-        return;                                         //   20
-    }
-    if(sample > maxValue)                                       //   80
-        return;                     // big, nothing to do (80% => 64%)  //   64
-
-    // symall, squeeze out old maximum... (20% => 16%) (22.6%)                   //   16
-    for(int i = maxIndex; i<minsSize-1; i++) {      // shuffle down...          //  160
-        mins[i] = mins[i+1];                                    //  160
-    }                                               //  160
-
-    // append...
-    mins[minsSize-1] = index;                                   //   16
-
-    // The order here is important; don't use an intermediate float
-    minSum -= maxValue;
-    minSum += sample;                                    //   16
-
-    // re-determine maximum...
-    determineMaximum();                                     //   16
-
-//    if (maxValue > minSum)
-//    {
-//        printf("maxValue %e > minSum %e  di %d\n", maxValue, minSum, mDataIndex);
-//        assert(0);
-//    }
-
-    // It can tip just below zero, but too much is wrong
-    assert(minSum >= -1e-8);
-    minSum = std::max(minSum, 0.0);
-}
-
-void Tracter::MinimaWindow::determineMaximum()
-{
-    maxIndex = 0;
-    maxValue = get(mins[0]);
-    IndexType *r = &mins[0];
-    for(int i = 1; i<minCount; i++) {
-        if(get(*++r) > maxValue) {
-            maxIndex = i;
-            maxValue = get(*r);
-        }
-    }
-}
-
-void Tracter::MinimaWindow::scanMinimum()
-{             // find new minimum in window, we don't already have
-    static const float floatMax = std::numeric_limits<float>::max();
-
-    float minValue = floatMax;
-    IndexType minIndex = -1;
-    int minIndexToSkip = 0;                 // current minIndex we should not consider 
-    IndexType minToSkip = mins[minIndexToSkip];           // current min we should not consider 
-
-    const IndexType windowStart = windowOffset > 0 ? windowOffset : 0;
-    const IndexType windowEnd = windowOffset + windowSize > dataSize ? dataSize : windowOffset + windowSize;
-    //const int windowEnd = windowOffset+windowSize;
-
-    for(IndexType i = windowStart; i<windowEnd; i++) {
-
-        if(minIndexToSkip<minCount && i == minToSkip) { // already have it?
-            minToSkip = mins[++minIndexToSkip]; // skip over element
-            continue;
-        }
-
-        float value = get(i);
-
-        if(value < minValue) {              // smallest so far...
-            minValue = value;           // remember this one
-            minIndex = i;
-        }
-    }
-
-    if(minIndex == -1) return;
-
-    // insert new value at correct index position.... doh!
-    int i;
-    for(i = minCount-1; i>=0 && minIndex<mins[i]; i--) {    // shuffle up...
-        mins[i+1] = mins[i];
-    }
-    // insert here...
-    maxIndex = i+1;
-    maxValue = get(minIndex);
-    mins[maxIndex] = minIndex;
-    minSum += maxValue;
-    minCount++;
-}
-
-void Tracter::MinimaWindow::dump(FILE *out) {
-    SlidingWindow::dump(out);
-    fprintf(out, "mins: [");
-    const char *sep = "";
-    for(int i = 0; i<minCount; i++) {
-        fprintf(out, "%s%e", sep, get(mins[i]));
-        sep = ",";
-    }
-    fprintf(out, "]");
-}
-
-void Tracter::SlidingWindow::setData(
-    Component<float>* iInput, int iDataIndex,
-    IndexType iMinIndex, CacheArea iCacheArea
-)
-{
-    assert(iInput);
-    mInput = iInput;
-    mDataIndex = iDataIndex;
-    mMinIndex = iMinIndex;
-    mCacheArea = iCacheArea;
-}
-
-
-float Tracter::SlidingWindow::get(IndexType iIndex)
-{
-    assert(iIndex >= mMinIndex);
-    assert(iIndex < mMinIndex + mCacheArea.Length());
-    int offset = (int)(iIndex - mMinIndex);
-    float* data = mInput->GetPointer(
-        (offset < mCacheArea.len[0])
-        ? mCacheArea.offset + offset
-        : offset - mCacheArea.len[0]
-    );
-    return data[mDataIndex];
-}
+#ifdef __SSE__
+# include <xmmintrin.h>
+#endif
 
+#include "Minima.h"
 
 Tracter::Minima::Minima(Component<float>* iInput, const char* iObjectName)
 {
@@ -242,22 +28,31 @@ Tracter::Minima::Minima(Component<float>* iInput, const char* iObjectName)
     MinSize(mInput, mNWindow+1, mNAhead);
 
     float gamma = GetEnv("Gamma", 0.2f);
-    int nGamma  = (int)(gamma * mNWindow);
+    mNMins = std::max(1, (int)(gamma * mNWindow));
 
-    mWindow.resize(mFrame.size);
-    for (int i=0; i<mFrame.size; i++)
-        mWindow[i] = new MinimaWindow(mNWindow, nGamma);
+    // The ring holds the window plus the datum that just left it
+    mRingSize = mNWindow + 1;
+    mRing.resize(mRingSize * mFrame.size);
+    if (mNMins == 1)
+    {
+        mDeque.resize(mRingSize * mFrame.size);
+        mHead.resize(mFrame.size);
+        mCount.resize(mFrame.size);
+    }
+    else
+    {
+        mMins.resize(mNMins * mFrame.size);
+        mMinCount.resize(mFrame.size);
+        mMaxIndex.resize(mFrame.size);
+        mMaxValue.resize(mFrame.size);
+        mMinSum.resize(mFrame.size);
+    }
+    reset();
 
     mCorrection = GetEnv("Correction", 1.0f / (1.5f * gamma) / (1.5f * gamma));
 
     mLastIndex = -1;
-    Verbose(1, "Window %d, %d ahead\n", mNWindow, mNAhead);
-}
-
-Tracter::Minima::~Minima() throw ()
-{
-    for (int i=0; i<mFrame.size; i++)
-        delete mWindow[i];
+    Verbose(1, "Window %d, %d ahead, %d minima\n", mNWindow, mNAhead, mNMins);
 }
 
 /**
@@ -295,27 +90,35 @@ bool Tracter::Minima::unaryFetch(IndexType iIndex, float* oData)
     // We're approaching the end; tell the windower
     if ((nGot < nGet) && mEndOfData < 0)
     {
-        IndexType dataSize = getIndex + nGot;
         mEndOfData = getIndex + nGot;
+        mDataSize = getIndex + nGot;
         Verbose(2, "EOD at %ld\n", getIndex + nGot);
-        for (int i=0; i<mFrame.size; i++)
-            mWindow[i]->setDataSize(dataSize);
+    }
+
+    // Copy new frames into the ring
+    for (int i=0; i<nGot; i++)
+    {
+        IndexType index = getIndex + i;
+        if (index <= mNewest)
+            continue;
+        float* p = mInput->GetPointer(
+            (i < ca.len[0]) ? ca.offset + i : i - ca.len[0]
+        );
+        float* r = &mRing[(index % mRingSize) * mFrame.size];
+        for (int j=0; j<mFrame.size; j++)
+            r[j] = p[j];
+        mNewest = index;
     }
 
     // At the beginning, which may not be iIndex = 0, prime the windower
     if (mLastIndex < 0)
     {
-        for (int i=0; i<mFrame.size; i++)
-            mWindow[i]->setData(mInput, i, getIndex, ca);
-
         // Shift in the first few samples
+        mOffset = getIndex - mNWindow;
         for (int a=0; a<nGot-1; a++)
         {
             Verbose(4, "Priming %d\n", a);
-            for (int i=0; i<mFrame.size; i++)
-            {
-                mWindow[i]->shift();
-            }
+            shift();
         }
         mLastIndex = iIndex;
     }
@@ -327,12 +130,20 @@ bool Tracter::Minima::unaryFetch(IndexType iIndex, float* oData)
     }
 
     Verbose(4, "Shifting\n");
-    for (int i=0; i<mFrame.size; i++)
-    {
-        mWindow[i]->setData(mInput, i, getIndex, ca);
-        mWindow[i]->shift();
-        oData[i] = mWindow[i]->getMean() * mCorrection;
-    }
+    shift();
+    if (mNMins == 1)
+        for (int i=0; i<mFrame.size; i++)
+        {
+            assert(mCount[i]);
+            IndexType min = mDeque[i*mRingSize + mHead[i]];
+            oData[i] = value(min, i) * mCorrection;
+        }
+    else
+        for (int i=0; i<mFrame.size; i++)
+        {
+            assert(mMinCount[i]);
+            oData[i] = (float)(mMinSum[i] / mMinCount[i]) * mCorrection;
+        }
 
     return true;
 }
@@ -341,7 +152,259 @@ void Tracter::Minima::Reset(bool iPropagate)
 {
     Verbose(2, "Reset\n");
     mLastIndex = -1;
-    for (int i=0; i<mFrame.size; i++)
-        mWindow[i]->reset();
+    reset();
     CachedComponent<float>::Reset(iPropagate);
 }
+
+/**
+ * Re-initialise the window to be completely before the left end of the
+ * data.
+ */
+void Tracter::Minima::reset()
+{
+    mOffset = -mNWindow;
+    mDataSize = std::numeric_limits<IndexType>::max();
+    mNewest = -1;
+    for (int i=0; i<mFrame.size; i++)
+        if (mNMins == 1)
+        {
+            mHead[i] = 0;
+            mCount[i] = 0;
+        }
+        else
+        {
+            mMinCount[i] = 0;
+            mMaxIndex[i] = -1;
+            mMaxValue[i] = 0.0f;
+            mMinSum[i] = 0.0;
+        }
+}
+
+/**
+ * Move the window one frame to the right.
+ */
+void Tracter::Minima::shift()
+{
+    mOffset++;
+    IndexType index = mOffset + mNWindow - 1;
+    const float* sample = (index < mDataSize)
+        ? &mRing[(index % mRingSize) * mFrame.size]
+        : 0;
+
+    if (mNMins == 1)
+    {
+        shiftDeque(index, sample);
+        return;
+    }
+
+    for (int i=0; i<mFrame.size; i++)
+        shrinkLeft(i);
+
+    int i = 0;
+#ifdef __SSE__
+    // Usually the new sample is bigger than all the minima held, in
+    // which case there is nothing to do; check four dimensions at once
+    if (sample)
+        for (; i <= mFrame.size-4; i += 4)
+        {
+            int big = _mm_movemask_ps(
+                _mm_cmpgt_ps(
+                    _mm_loadu_ps(sample+i), _mm_loadu_ps(&mMaxValue[i])
+                )
+            );
+            for (int j=0; j<4; j++)
+                if (!(big & (1 << j)) || (mMinCount[i+j] < mNMins))
+                    growRight(i+j, index, sample);
+        }
+#endif
+    for (; i<mFrame.size; i++)
+        growRight(i, index, sample);
+}
+
+/**
+ * Shift for a single minimum.  Each deque holds the indices of the
+ * frames that could yet become the minimum, with increasing values
+ * from head to tail, so the head is the minimum.
+ */
+void Tracter::Minima::shiftDeque(IndexType iIndex, const float* iSample)
+{
+    for (int i=0; i<mFrame.size; i++)
+    {
+        IndexType* deque = &mDeque[i*mRingSize];
+        int& head = mHead[i];
+        int& count = mCount[i];
+
+        // Drop the head if it has left the window
+        while (count && (deque[head] < mOffset))
+        {
+            head = (head + 1) % mRingSize;
+            count--;
+        }
+
+        // Anything at the tail that is no smaller can never be the minimum
+        if (iSample)
+        {
+            while (
+                count &&
+                (value(deque[(head + count - 1) % mRingSize], i) >= iSample[i])
+            )
+                count--;
+            deque[(head + count) % mRingSize] = iIndex;
+            count++;
+        }
+    }
+}
+
+/**
+ * Collapse the left end of the window right one element.
+ */
+void Tracter::Minima::shrinkLeft(int iDim)
+{
+    IndexType* mins = &mMins[iDim*mNMins];
+    int& minCount = mMinCount[iDim];
+    if (minCount == 0 || mOffset <= mins[0])
+        return;    // nothing to do (80%)
+    minCount--;
+    mMinSum[iDim] -= value(mins[0], iDim);
+    for (int i = 0; i<minCount; i++)   // remove mins 0, by shuffling others left
+        mins[i] = mins[i+1];
+    if (--mMaxIndex[iDim] < 0)
+        determineMaximum(iDim);        // lost maximum, re-determine (20% => 4%)
+}
+
+/**
+ * Extend the right end of the window right one element.  iSample is
+ * null if iIndex is off the end of the data.
+ */
+void Tracter::Minima::growRight(
+    int iDim, IndexType iIndex, const float* iSample
+)
+{
+    IndexType* mins = &mMins[iDim*mNMins];
+    int& minCount = mMinCount[iDim];
+    int& maxIndex = mMaxIndex[iDim];
+    float& maxValue = mMaxValue[iDim];
+    double& minSum = mMinSum[iDim];
+
+    if (!iSample)
+    {
+        // If mins were shifted out, we need to re-scan
+        if (minCount < mNMins)
+            scanMinimum(iDim);
+        return;
+    }
+
+    const float sample = iSample[iDim];
+
+    if (minCount < mNMins)
+    {
+        // Room for a little one
+        if (maxIndex == -1 || sample <= maxValue)
+        {
+            // Small, so add on end.  If the mins all left the window,
+            // maxValue is that of the last to leave; it's no bigger
+            // than anything left in the window, but it's no longer
+            // the maximum.
+            if (maxIndex == -1 || minCount == 0 || sample == maxValue)
+            {
+                maxIndex = minCount;
+                maxValue = sample;
+            }
+            mins[minCount++] = iIndex;
+            minSum += sample;
+        }
+        else
+        {
+            // Big, look for new minimum
+            scanMinimum(iDim);
+        }
+        return;
+    }
+    if (sample > maxValue)
+        return;                     // big, nothing to do (80% => 64%)
+
+    // Small, squeeze out old maximum and append
+    for (int i = maxIndex; i<mNMins-1; i++)
+        mins[i] = mins[i+1];
+    mins[mNMins-1] = iIndex;
+
+    // The order here is important; don't use an intermediate float
+    minSum -= maxValue;
+    minSum += sample;
+
+    determineMaximum(iDim);
+
+    // It can tip just below zero, but too much is wrong
+    assert(minSum >= -1e-8);
+    minSum = std::max(minSum, 0.0);
+}
+
+/**
+ * Determine which of the minima is the largest.
+ */
+void Tracter::Minima::determineMaximum(int iDim)
+{
+    const IndexType* mins = &mMins[iDim*mNMins];
+    int& maxIndex = mMaxIndex[iDim];
+    float& maxValue = mMaxValue[iDim];
+    maxIndex = 0;
+    maxValue = value(mins[0], iDim);
+    for (int i = 1; i<mMinCount[iDim]; i++)
+    {
+        float v = value(mins[i], iDim);
+        if (v > maxValue)
+        {
+            maxIndex = i;
+            maxValue = v;
+        }
+    }
+}
+
+/**
+ * Find the minimum element in the window that isn't already held, and
+ * insert it in the minima.
+ */
+void Tracter::Minima::scanMinimum(int iDim)
+{
+    static const float floatMax = std::numeric_limits<float>::max();
+
+    IndexType* mins = &mMins[iDim*mNMins];
+    int& minCount = mMinCount[iDim];
+
+    float minValue = floatMax;
+    IndexType minIndex = -1;
+    int minIndexToSkip = 0;               // current min we should not consider
+    IndexType minToSkip = mins[minIndexToSkip];
+
+    const IndexType windowStart = std::max(mOffset, (IndexType)0);
+    const IndexType windowEnd = std::min(mOffset + mNWindow, mDataSize);
+    for (IndexType i = windowStart; i<windowEnd; i++)
+    {
+        if (minIndexToSkip<minCount && i == minToSkip)
+        {
+            // Already have it
+            minToSkip = mins[++minIndexToSkip];
+            continue;
+        }
+
+        float v = value(i, iDim);
+        if (v < minValue)
+        {
+            minValue = v;
+            minIndex = i;
+        }
+    }
+
+    if (minIndex == -1)
+        return;
+
+    // Insert new value at correct index position
+    int i;
+    for (i = minCount-1; i>=0 && minIndex<mins[i]; i--)
+        mins[i+1] = mins[i];
+    mMaxIndex[iDim] = i+1;
+    mMaxValue[iDim] = minValue;
+    mins[i+1] = minIndex;
+    mMinSum[iDim] += minValue;
+    minCount++;
+}
@@ -7,8 +7,29 @@
 #include <cmath>
 #include <cstdio>
 
+#ifdef __SSE__
+# include <xmmintrin.h>
+#endif
+
 #include "Modulation.h"
 
+Tracter::SlidingDFT::SlidingDFT(int iSize)
+{
+    mSize = iSize;
+    mReal.resize(iSize);
+    mImag.resize(iSize);
+    Reset();
+}
+
+void Tracter::SlidingDFT::Reset()
+{
+    for (int i=0; i<mSize; i++)
+    {
+        mReal[i] = 0.0f;
+        mImag[i] = 0.0f;
+    }
+}
+
 void Tracter::SlidingDFT::SetRotation(int iBin, int iNBins)
 {
     float a = 2.0f * M_PI * iBin / iNBins;
@@ -17,12 +38,67 @@ void Tracter::SlidingDFT::SetRotation(int iBin, int iNBins)
     mRotation = complex(r, i);
 }
 
-const Tracter::complex& Tracter::SlidingDFT::Transform(float iNew, float iOld)
+/**
+ * Shift in a new frame and shift out an old one.  A null iOld means
+ * zero, which is what is shifted out at the beginning.
+ */
+void Tracter::SlidingDFT::Transform(const float* iNew, const float* iOld)
 {
-    float tmp = iNew - iOld;
-    complex ctmp = mState + tmp;
-    mState = mRotation * ctmp;
-    return mState;
+    assert(iNew);
+    const float rr = mRotation.real();
+    const float ri = mRotation.imag();
+    float* re = &mReal[0];
+    float* im = &mImag[0];
+
+    int i = 0;
+#ifdef __SSE__
+    __m128 vrr = _mm_set1_ps(rr);
+    __m128 vri = _mm_set1_ps(ri);
+    for (; i <= mSize-4; i += 4)
+    {
+        __m128 d = _mm_loadu_ps(iNew+i);
+        if (iOld)
+            d = _mm_sub_ps(d, _mm_loadu_ps(iOld+i));
+        __m128 sr = _mm_add_ps(_mm_loadu_ps(re+i), d);
+        __m128 si = _mm_loadu_ps(im+i);
+        _mm_storeu_ps(
+            re+i, _mm_sub_ps(_mm_mul_ps(vrr, sr), _mm_mul_ps(vri, si))
+        );
+        _mm_storeu_ps(
+            im+i, _mm_add_ps(_mm_mul_ps(vrr, si), _mm_mul_ps(vri, sr))
+        );
+    }
+#endif
+    for (; i<mSize; i++)
+    {
+        float sr = re[i] + (iOld ? iNew[i] - iOld[i] : iNew[i]);
+        float si = im[i];
+        re[i] = rr * sr - ri * si;
+        im[i] = rr * si + ri * sr;
+    }
+}
+
+/**
+ * Write the magnitude of each channel divided by iDivisor.
+ */
+void Tracter::SlidingDFT::Magnitude(float* oData, float iDivisor) const
+{
+    const float* re = &mReal[0];
+    const float* im = &mImag[0];
+
+    int i = 0;
+#ifdef __SSE__
+    __m128 div = _mm_set1_ps(iDivisor);
+    for (; i <= mSize-4; i += 4)
+    {
+        __m128 r = _mm_loadu_ps(re+i);
+        __m128 j = _mm_loadu_ps(im+i);
+        __m128 m = _mm_add_ps(_mm_mul_ps(r, r), _mm_mul_ps(j, j));
+        _mm_storeu_ps(oData+i, _mm_div_ps(_mm_sqrt_ps(m), div));
+    }
+#endif
+    for (; i<mSize; i++)
+        oData[i] = sqrtf(re[i] * re[i] + im[i] * im[i]) / iDivisor;
 }
 
 Tracter::Modulation::Modulation(
@@ -33,18 +109,31 @@ Tracter::Modulation::Modulation(
     mInput = iInput;
     Connect(iInput);
 
-    mFrame.size = 1;
-    assert(iInput->Frame().size == 1);
+    mInputSize = iInput->Frame().size;
+    if (mInputSize == 0)
+        mInputSize = 1;
 
     /* For a 100Hz frame rate and bin 1 = 4Hz, we have nBins = 100/4 =
      * 25 */
     float freq = GetEnv("Freq", 4.0f);
     int bin = GetEnv("Bin", 1);
+    int bins = GetEnv("Bins", 1);
     mNBins = (int)(FrameRate() / freq + 0.5f);
-    mDFT.SetRotation(bin, mNBins);
+    /* Bin isn't checked, as it never was; more bins than the DFT has
+     * would just repeat */
+    if (bins > mNBins)
+        bins = mNBins;
+    if (bins < 1)
+        bins = 1;
+    mDFT.resize(bins, SlidingDFT(mInputSize));
+    for (int b=0; b<bins; b++)
+        mDFT[b].SetRotation(bin + b, mNBins);
+    mFrame.size = mInputSize * bins;
+
+    /* The window, plus the datum just behind it that's shifted out */
     mLookAhead = mNBins / 2; // Round down
     mLookBehind = mNBins - mLookAhead - 1;
-    MinSize(mInput, mNBins, mLookAhead);
+    MinSize(mInput, mNBins + 1, mLookAhead);
     mIndex = -1;
 
     Verbose(2, "NBins=%d (-%d+%d)\n", mNBins, mLookBehind, mLookAhead);
@@ -62,6 +151,7 @@ bool Tracter::Modulation::UnaryFetch(IndexType iIndex, float* oData)
     Verbose(3, "iIndex %ld\n", iIndex);
     assert(iIndex == mIndex+1);
     mIndex = iIndex;
+    int bins = (int)mDFT.size();
 
     if (iIndex == 0)
     {
@@ -71,51 +161,55 @@ bool Tracter::Modulation::UnaryFetch(IndexType iIndex, float* oData)
          * is, reset, then shift in mLookBehind + 1 + mLookAhead
          * samples.  Below, assume a window of 12+1+12 = 25 frames.
          */
-        mDFT.Reset();
         SizeType len = mLookAhead;
         const float* p = mInput->ContiguousRead(0, len);
         if (!p)
             return false;
         assert(len == mLookAhead); // The cache should be big enough
 
-        /* Prime with the first sample for all the missing ones */
-        for (SizeType i=0; i<mLookBehind+1; i++)
-            mDFT.Transform(p[0], 0.0f);
+        for (int b=0; b<bins; b++)
+        {
+            mDFT[b].Reset();
 
-        /* Prime the rest with the look-ahead; this includes the first
-         * sample once more, so there are 14 copies of the first
-         * sample */
-        for (SizeType i=0; i<mLookAhead; i++)
-            mDFT.Transform(p[i], 0.0f);
+            /* Prime with the first sample for all the missing ones */
+            for (SizeType i=0; i<mLookBehind+1; i++)
+                mDFT[b].Transform(p);
+
+            /* Prime the rest with the look-ahead; this includes the
+             * first sample once more, so there are 14 copies of the
+             * first sample */
+            for (SizeType i=0; i<mLookAhead; i++)
+                mDFT[b].Transform(p + i*mInputSize);
+        }
     }
 
-    /* Read the old value - the one just behind the DFT window.  This
-     * should be index zero the first 14 times for a 12+1+12 window */
+    /* Read from the old value - the one just behind the DFT window -
+     * to the new lookahead value.  The old value should be index zero
+     * the first 14 times for a 12+1+12 window */
     IndexType loIndex = iIndex > mLookBehind
         ? iIndex - mLookBehind - 1
         : 0;
-    const float* oldVal = mInput->UnaryRead(loIndex);
-    if (!oldVal)
-        return false;
+    CacheArea ca;
+    SizeType nGet = iIndex + mLookAhead - loIndex + 1;
+    SizeType nGot = mInput->Read(ca, loIndex, nGet);
 
     /* Check that the current value is valid */
-    if (!mInput->UnaryRead(iIndex))
+    if (loIndex + nGot <= iIndex)
         return false;
 
-    /* Now the new lookahead value.  Read back from the end until it's
-     * found.  It'll be the first hit unless near the end */
-    const float* newVal;
-    for (IndexType hiIndex=iIndex+mLookAhead; hiIndex>=iIndex; hiIndex--)
-    {
-        newVal = mInput->UnaryRead(hiIndex);
-        if (newVal)
-            break;
-    }
+    /* The new value is the last one read; it'll be the lookahead
+     * unless near the end */
+    SizeType last = nGot - 1;
+    const float* oldVal = mInput->GetPointer(ca.offset);
+    const float* newVal = mInput->GetPointer(
+        (last < ca.len[0]) ? ca.offset + last : last - ca.len[0]
+    );
 
     /* Do the transform */
-    complex tmp = mDFT.Transform(*newVal, *oldVal);
-    float filter = abs(tmp);
-    filter /= mNBins;
-    *oData = filter;
+    for (int b=0; b<bins; b++)
+    {
+        mDFT[b].Transform(newVal, oldVal);
+        mDFT[b].Magnitude(oData + b*mInputSize, (float)mNBins);
+    }
     return true;
 }
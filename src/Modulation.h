@@ -8,6 +8,7 @@
 #define MODULATION_H
 
 #include <complex>
+#include <vector>
 
 #include "CachedComponent.h"
 
@@ -18,20 +19,24 @@ namespace Tracter
     /**
      * Sliding DFT
      *
-     * An efficient way of calculating a single bin of a DFT.
+     * An efficient way of calculating a single bin of a DFT.  One DFT
+     * is run for each of iSize channels; the state is held as separate
+     * real and imaginary arrays so the channels can be updated
+     * together using SSE.
      */
     class SlidingDFT
     {
     public:
+        SlidingDFT(int iSize = 1);
         void SetRotation(int iBin, int iNBins);
-        const complex& Transform(float iNew, float iOld);
-        void Reset()
-        {
-            mState = complex(0.0f, 0.0f);
-        }
+        void Transform(const float* iNew, const float* iOld = 0);
+        void Magnitude(float* oData, float iDivisor) const;
+        void Reset();
 
     private:
-        complex mState;
+        int mSize;
+        std::vector<float> mReal;
+        std::vector<float> mImag;
         complex mRotation;
     };
 
@@ -39,13 +44,18 @@ namespace Tracter
      * A feature based on modulation.
      *
      * The input is filtered with a sliding DFT giving a feature that
-     * is similar in principle to RASTA.
+     * is similar in principle to RASTA.  Each dimension of the input
+     * is filtered separately.  Bins consecutive DFT bins are output,
+     * starting at Bin; the output is all the dimensions of the first
+     * bin, then all those of the next, and so on.  Bins is limited to
+     * the size of the DFT.
      */
     class Modulation : public CachedComponent<float>
     {
     public:
         Modulation(Component<float>* iInput,
                    const char* iObjectName = "Modulation");
+        virtual ~Modulation() throw () {}
 
     protected:
 
@@ -56,6 +66,7 @@ namespace Tracter
         {
             CachedComponent<float>::DotHook();
             DotRecord(1, "nBins=%d", mNBins);
+            DotRecord(1, "bins=%d", (int)mDFT.size());
             DotRecord(1, "ahead=%d", mLookAhead);
             DotRecord(1, "behind=%d", mLookBehind);
         }
@@ -66,7 +77,8 @@ namespace Tracter
         int mNBins;
         SizeType mLookAhead;
         SizeType mLookBehind;
-        SlidingDFT mDFT;
+        int mInputSize;
+        std::vector<SlidingDFT> mDFT;
     };
 
 }
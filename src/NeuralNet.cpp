@@ -0,0 +1,486 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#include "TracterObject.h"
+#include "Kernel.h"
+#include "NeuralNet.h"
+
+namespace Tracter
+{
+    /** Machine types as enumerated by Torch3's SKMLP */
+    enum TorchMachine
+    {
+        TORCH_LINEAR = 0,
+        TORCH_SIGMOID = 2,
+        TORCH_LOGSOFTMAX = 3,
+        TORCH_SOFTMAX = 4,
+        TORCH_CONNECTED = 5,
+        TORCH_TANH = 7,
+        TORCH_BLASLINEAR = 8,
+        TORCH_EXP = 11
+    };
+
+    /** Reverse the bytes of iCount items of iSize bytes each */
+    static void swap(void* ioData, int iSize, int iCount)
+    {
+        char* p = (char*)ioData;
+        for (int i=0; i<iCount; i++, p+=iSize)
+            for (int j=0; j<iSize/2; j++)
+            {
+                char tmp = p[j];
+                p[j] = p[iSize-1-j];
+                p[iSize-1-j] = tmp;
+            }
+    }
+}
+
+Tracter::NeuralNet::NeuralNet(const char* iObjectName)
+{
+    mObjectName = iObjectName;
+    mFile = 0;
+    mSwap = false;
+    mQuantised = false;
+}
+
+Tracter::NeuralNet::~NeuralNet()
+{
+    for (size_t l=0; l<mLayer.size(); l++)
+        Kernel::Free(mLayer[l].weights);
+}
+
+int Tracter::NeuralNet::Inputs() const
+{
+    assert(mLayer.size() > 0);
+    return mLayer.front().inputs;
+}
+
+int Tracter::NeuralNet::Outputs() const
+{
+    assert(mLayer.size() > 0);
+    return mLayer.back().outputs;
+}
+
+/**
+ * Load a network saved by Torch3.
+ */
+void Tracter::NeuralNet::Load(const char* iFileName)
+{
+    if (!iFileName)
+        throw Exception("%s: Null file name", mObjectName);
+    mFile = fopen(iFileName, "rb");
+    if (!mFile)
+        throw Exception("%s: Failed to open file %s", mObjectName, iFileName);
+
+    try
+    {
+        mSwap = false;
+        loadConnected();
+    }
+    catch (...)
+    {
+        fclose(mFile);
+        mFile = 0;
+        throw;
+    }
+    fclose(mFile);
+    mFile = 0;
+
+    if (mLayer.size() == 0)
+        throw Exception("%s: No layers in %s", mObjectName, iFileName);
+    if (mLayer.back().activation == LOGSOFTMAX)
+        mLayer.back().activation = SOFTMAX;
+}
+
+/**
+ * Read a tagged block header as written by Torch3's
+ * XFile::taggedWrite(): the tag length, the tag, the item size and
+ * the item count.  The byte order is inferred from the first tag
+ * length in the file.  Throws if the tag, size (unless iSize is zero)
+ * or count is unexpected, and returns the item size.
+ */
+int Tracter::NeuralNet::readTag(const char* iTag, int iSize, int iCount)
+{
+    int length;
+    readBlock(&length, sizeof(int), 1);
+    if ((length <= 0) || (length > 255))
+    {
+        swap(&length, sizeof(int), 1);
+        if ((length <= 0) || (length > 255))
+            throw Exception("%s: Not a Torch3 file", mObjectName);
+        mSwap = !mSwap;
+    }
+
+    char tag[256];
+    readBlock(tag, 1, length);
+    tag[length] = '\0';
+    if (strcmp(tag, iTag))
+        throw Exception("%s: Expected tag %s, got %s", mObjectName, iTag, tag);
+
+    int size;
+    int count;
+    readBlock(&size, sizeof(int), 1);
+    readBlock(&count, sizeof(int), 1);
+    if (((iSize > 0) && (size != iSize)) || (count != iCount))
+        throw Exception("%s: Tag %s has size %dx%d, expected %dx%d",
+                        mObjectName, iTag, size, count, iSize, iCount);
+    return size;
+}
+
+int Tracter::NeuralNet::readInt(const char* iTag)
+{
+    int value;
+    readTag(iTag, sizeof(int), 1);
+    readBlock(&value, sizeof(int), 1);
+    return value;
+}
+
+void Tracter::NeuralNet::readBlock(void* oData, int iSize, int iCount)
+{
+    assert(mFile);
+    if ((int)fread(oData, iSize, iCount, mFile) != iCount)
+        throw Exception("%s: Unexpected end of file", mObjectName);
+    if (mSwap)
+        swap(oData, iSize, iCount);
+}
+
+/**
+ * Read a CONNECTED machine, i.e., a whole SKMLP, appending its layers.
+ */
+void Tracter::NeuralNet::loadConnected()
+{
+    if (readInt("machine_type") != TORCH_CONNECTED)
+        throw Exception("%s: Expected a CONNECTED machine", mObjectName);
+
+    int nLayers = readInt("n_layers");
+    for (int i=0; i<nLayers; i++)
+    {
+        if (readInt("machines_on_layer") != 1)
+            throw Exception("%s: Only one machine per layer is supported",
+                            mObjectName);
+        int type = readInt("machine_type");
+        char hidden;
+        readTag("hidden", 1, 1);
+        readBlock(&hidden, 1, 1);
+
+        Activation activation = LINEAR;
+        switch (type)
+        {
+        case TORCH_LINEAR:
+        case TORCH_BLASLINEAR:
+        {
+            // Weights are row major, one row per output, then the bias
+            Layer layer;
+            layer.inputs = readInt("n_inputs");
+            layer.outputs = readInt("n_outputs");
+            layer.activation = LINEAR;
+            if ((mLayer.size() > 0) && (mLayer.back().outputs != layer.inputs))
+                throw Exception("%s: Layer %d has %d inputs, expected %d",
+                                mObjectName, (int)mLayer.size(),
+                                layer.inputs, mLayer.back().outputs);
+            int nWeights = layer.inputs * layer.outputs;
+            int nParams = nWeights + layer.outputs;
+
+            // Pad the rows to the unrolling of DotAligned() so every
+            // row is aligned; the padding is zero
+            layer.stride = Kernel::Pad(layer.inputs, Kernel::cAlignFloats*2);
+            layer.weights = Kernel::Allocate(layer.outputs * layer.stride);
+            for (int j=0; j<layer.outputs * layer.stride; j++)
+                layer.weights[j] = 0.0f;
+            layer.bias.resize(layer.outputs);
+            mLayer.push_back(layer);
+
+            // Torch3 may have been compiled with double as its real
+            std::vector<double> params(nParams);
+            int size = readTag("PARAMS", 0, nParams);
+            if (size == sizeof(float))
+            {
+                std::vector<float> tmp(nParams);
+                readBlock(&tmp[0], sizeof(float), nParams);
+                params.assign(tmp.begin(), tmp.end());
+            }
+            else if (size == sizeof(double))
+                readBlock(&params[0], sizeof(double), nParams);
+            else
+                throw Exception("%s: Parameters of size %d",
+                                mObjectName, size);
+            for (int r=0; r<layer.outputs; r++)
+                for (int c=0; c<layer.inputs; c++)
+                    layer.weights[r * layer.stride + c] =
+                        (float)params[r * layer.inputs + c];
+            for (int j=0; j<layer.outputs; j++)
+                mLayer.back().bias[j] = (float)params[nWeights + j];
+            continue;
+        }
+        case TORCH_SIGMOID:
+            activation = SIGMOID;
+            break;
+        case TORCH_TANH:
+            activation = TANH;
+            break;
+        case TORCH_SOFTMAX:
+            activation = SOFTMAX;
+            break;
+        case TORCH_LOGSOFTMAX:
+            activation = LOGSOFTMAX;
+            break;
+        case TORCH_EXP:
+            activation = EXP;
+            break;
+        case TORCH_CONNECTED:
+            // The nested machine starts with its own type
+            loadConnected();
+            continue;
+        default:
+            throw Exception("%s: Unsupported Torch3 machine type %d",
+                            mObjectName, type);
+        }
+
+        // Units apply to the previous linear layer
+        int units = readInt("n_units");
+        if ((mLayer.size() == 0) || (mLayer.back().activation != LINEAR))
+            throw Exception("%s: Units must follow a linear layer",
+                            mObjectName);
+        if (mLayer.back().outputs != units)
+            throw Exception("%s: %d units after a layer of %d outputs",
+                            mObjectName, units, mLayer.back().outputs);
+        mLayer.back().activation = activation;
+    }
+}
+
+/**
+ * Run iNFrames frames through the network.  Frames are iInputStride
+ * and iOutputStride floats apart.
+ */
+void Tracter::NeuralNet::Forward(
+    const float* iInput, int iInputStride,
+    float* oOutput, int iOutputStride, int iNFrames
+)
+{
+    assert(mLayer.size() > 0);
+    const Layer& layer = mLayer[0];
+    int stride;
+    float* output = layerOutput(0, oOutput, iOutputStride, iNFrames, stride);
+    if (mQuantised)
+        multiplyQuantised(layer, iInput, iInputStride,
+                          output, stride, iNFrames);
+    else
+        Kernel::MatrixMultiply(
+            layer.weights, layer.outputs, layer.inputs, layer.stride,
+            iInput, iInputStride, output, stride, iNFrames, false
+        );
+    forward(output, stride, oOutput, iOutputStride, iNFrames);
+}
+
+/**
+ * Run iNFrames frames through the network, where the input of each is
+ * a window of iWindow consecutive frames of Inputs()/iWindow floats.
+ * iInput is the iNFrames+iWindow-1 frames spanned by the windows,
+ * contiguous, so consecutive network inputs overlap.  The first layer
+ * is then the sum over the window of the corresponding block of
+ * weight columns times the frames at that offset, and no window is
+ * ever copied out.
+ */
+void Tracter::NeuralNet::ForwardWindow(
+    const float* iInput, int iWindow,
+    float* oOutput, int iOutputStride, int iNFrames
+)
+{
+    assert(mLayer.size() > 0);
+    assert(iWindow > 0);
+    const Layer& layer = mLayer[0];
+    int size = layer.inputs / iWindow;
+    assert(size * iWindow == layer.inputs);
+    int stride;
+    float* output = layerOutput(0, oOutput, iOutputStride, iNFrames, stride);
+    if (mQuantised)
+        // The windows are contiguous, so each starts size floats on
+        multiplyQuantised(layer, iInput, size, output, stride, iNFrames);
+    else
+        for (int k=0; k<iWindow; k++)
+            Kernel::MatrixMultiply(
+                layer.weights + k*size, layer.outputs, size, layer.stride,
+                iInput + k*size, size, output, stride, iNFrames, k > 0
+            );
+    forward(output, stride, oOutput, iOutputStride, iNFrames);
+}
+
+/**
+ * Switch to 8 bit inference.  The weights of each output (i.e., each
+ * row) are scaled to [-127,127] and rounded.  At run time the inputs
+ * of each layer are scaled, frame by frame, to [-63,63] and offset by
+ * 64, so they fit in unsigned 7 bits, and the offset is removed again
+ * using the sums of the rows.  The float weights are kept, so
+ * Forward() results can be compared with a float network loaded from
+ * the same file.
+ */
+void Tracter::NeuralNet::Quantise()
+{
+    for (size_t l=0; l<mLayer.size(); l++)
+    {
+        Layer& layer = mLayer[l];
+        layer.quantised.resize(layer.outputs * layer.inputs);
+        layer.scale.resize(layer.outputs);
+        layer.sum.resize(layer.outputs);
+        for (int r=0; r<layer.outputs; r++)
+        {
+            const float* row = layer.weights + r * layer.stride;
+            float max = 0.0f;
+            for (int c=0; c<layer.inputs; c++)
+                max = std::max(max, fabsf(row[c]));
+            float scale = (max > 0.0f) ? max / 127.0f : 1.0f;
+            signed char* qrow = &layer.quantised[r * layer.inputs];
+            int sum = 0;
+            for (int c=0; c<layer.inputs; c++)
+            {
+                qrow[c] = (signed char)floorf(row[c] / scale + 0.5f);
+                sum += qrow[c];
+            }
+            layer.scale[r] = scale;
+            layer.sum[r] = sum;
+        }
+    }
+    mQuantised = true;
+}
+
+/**
+ * The 8 bit equivalent of MatrixMultiply().  The input of frame f is
+ * the Inputs() floats starting iInputStep floats on from that of
+ * frame f-1, so the windows of ForwardWindow() can overlap.  Each
+ * frame's input is quantised with its own scale, so the result for a
+ * frame doesn't depend on which other frames are in the block.
+ */
+void Tracter::NeuralNet::multiplyQuantised(
+    const Layer& iLayer, const float* iInput, int iInputStep,
+    float* oOutput, int iOutputStride, int iNFrames
+)
+{
+    assert(iLayer.quantised.size() > 0);
+    if (mQInput.size() < (size_t)iLayer.inputs)
+        mQInput.resize(iLayer.inputs);
+    unsigned char* q = &mQInput[0];
+
+    for (int f=0; f<iNFrames; f++)
+    {
+        const float* input = iInput + f * iInputStep;
+        float max = 0.0f;
+        for (int j=0; j<iLayer.inputs; j++)
+            max = std::max(max, fabsf(input[j]));
+        float scale = (max > 0.0f) ? max / 63.0f : 1.0f;
+        float rscale = 1.0f / scale;
+        for (int j=0; j<iLayer.inputs; j++)
+        {
+            int v = (int)floorf(input[j] * rscale + 0.5f);
+            q[j] = (unsigned char)(std::min(std::max(v, -63), 63) + 64);
+        }
+
+        float* output = oOutput + f * iOutputStride;
+        for (int r=0; r<iLayer.outputs; r++)
+        {
+            int dot = Kernel::DotInt8(
+                q, &iLayer.quantised[r * iLayer.inputs], iLayer.inputs
+            );
+            output[r] = (dot - 64 * iLayer.sum[r]) * scale * iLayer.scale[r];
+        }
+    }
+}
+
+/**
+ * Where layer iLayer should write its output: the caller's buffer for
+ * the last layer, otherwise one of the two intermediate buffers.
+ */
+float* Tracter::NeuralNet::layerOutput(
+    int iLayer, float* oOutput, int iOutputStride, int iNFrames, int& oStride
+)
+{
+    if (iLayer == (int)mLayer.size() - 1)
+    {
+        oStride = iOutputStride;
+        return oOutput;
+    }
+    std::vector<float>& buffer = mBuffer[iLayer % 2];
+    int outputs = mLayer[iLayer].outputs;
+    if (buffer.size() < (size_t)(outputs * iNFrames))
+        buffer.resize(outputs * iNFrames);
+    oStride = outputs;
+    return &buffer[0];
+}
+
+/**
+ * Given the linear output of the first layer, apply its activation and
+ * run the remaining layers.
+ */
+void Tracter::NeuralNet::forward(
+    float* ioData, int iStride,
+    float* oOutput, int iOutputStride, int iNFrames
+)
+{
+    float* input = ioData;
+    int inputStride = iStride;
+    for (size_t l=0; l<mLayer.size(); l++)
+    {
+        const Layer& layer = mLayer[l];
+        float* output = input;
+        int outputStride = inputStride;
+        if (l > 0)
+        {
+            output = layerOutput(l, oOutput, iOutputStride, iNFrames,
+                                 outputStride);
+            if (mQuantised)
+                multiplyQuantised(layer, input, inputStride,
+                                  output, outputStride, iNFrames);
+            else
+                Kernel::MatrixMultiply(
+                    layer.weights, layer.outputs, layer.inputs,
+                    layer.stride, input, inputStride,
+                    output, outputStride, iNFrames, false
+                );
+        }
+        for (int f=0; f<iNFrames; f++)
+            activate(layer, output + f * outputStride);
+
+        input = output;
+        inputStride = outputStride;
+    }
+}
+
+/**
+ * Add the bias and apply the activation function to one frame.
+ */
+void Tracter::NeuralNet::activate(const Layer& iLayer, float* ioData)
+{
+    const float* bias = &iLayer.bias[0];
+    int n = iLayer.outputs;
+    switch (iLayer.activation)
+    {
+    case SIGMOID:
+        Kernel::Sigmoid(bias, ioData, n);
+        break;
+    case SOFTMAX:
+        Kernel::SoftMax(bias, ioData, n);
+        break;
+    case LOGSOFTMAX:
+        Kernel::SoftMax(bias, ioData, n);
+        Kernel::Log(ioData, ioData, n);
+        break;
+    case TANH:
+        for (int i=0; i<n; i++)
+            ioData[i] = tanhf(ioData[i] + bias[i]);
+        break;
+    case EXP:
+        for (int i=0; i<n; i++)
+            ioData[i] += bias[i];
+        Kernel::Exp(ioData, ioData, n);
+        break;
+    default:
+        for (int i=0; i<n; i++)
+            ioData[i] += bias[i];
+    }
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#ifndef NEURALNET_H
+#define NEURALNET_H
+
+#include <cstdio>
+#include <vector>
+
+namespace Tracter
+{
+    /**
+     * A feed-forward neural network, as used by MLP.
+     *
+     * Each layer is a full matrix, a bias and an activation function.
+     * Load() reads the Torch3 format written by SKMLP::saveXFile()
+     * (via DiskXFile), but doesn't need Torch3 itself.  Linear layers
+     * (Linear or BlasLinear) may be followed by sigmoid, tanh,
+     * softmax, log-softmax or exponential units; a final log-softmax
+     * is replaced by a softmax, as the MLP always did.  Nested
+     * networks are flattened; more than one machine on a layer is not
+     * supported.
+     *
+     * Forward() runs any number of frames at once, so each layer is
+     * one matrix-matrix product.  ForwardWindow() does the same for
+     * inputs that are overlapping windows of a sequence of frames.
+     * After Quantise(), both use 8 bit weights and activations for
+     * the matrix products.
+     */
+    class NeuralNet
+    {
+    public:
+        NeuralNet(const char* iObjectName = "NeuralNet");
+        ~NeuralNet();
+
+        void Load(const char* iFileName);
+
+        int Inputs() const;
+        int Outputs() const;
+        int Layers() const { return (int)mLayer.size(); }
+
+        void Forward(
+            const float* iInput, int iInputStride,
+            float* oOutput, int iOutputStride, int iNFrames
+        );
+        void ForwardWindow(
+            const float* iInput, int iWindow,
+            float* oOutput, int iOutputStride, int iNFrames
+        );
+
+        void Quantise();
+        bool Quantised() const { return mQuantised; }
+
+    private:
+        NeuralNet(const NeuralNet&);
+        NeuralNet& operator =(const NeuralNet&);
+
+        enum Activation
+        {
+            LINEAR,
+            SIGMOID,
+            TANH,
+            SOFTMAX,
+            LOGSOFTMAX,
+            EXP
+        };
+
+        struct Layer
+        {
+            int inputs;
+            int outputs;
+            int stride;             ///< floats from one row to the next
+            float* weights;         ///< outputs rows, each aligned
+            std::vector<float> bias;
+            Activation activation;
+            std::vector<signed char> quantised; ///< 8 bit weights
+            std::vector<float> scale;           ///< per row of quantised
+            std::vector<int> sum;               ///< per row of quantised
+        };
+
+        const char* mObjectName;
+        std::vector<Layer> mLayer;
+        std::vector<float> mBuffer[2];
+        bool mQuantised;
+        std::vector<unsigned char> mQInput;
+
+        FILE* mFile;
+        bool mSwap;
+        void loadConnected();
+        int readTag(const char* iTag, int iSize, int iCount);
+        int readInt(const char* iTag);
+        void readBlock(void* oData, int iSize, int iCount);
+        float* layerOutput(
+            int iLayer, float* oOutput, int iOutputStride, int iNFrames,
+            int& oStride
+        );
+        void multiplyQuantised(
+            const Layer& iLayer, const float* iInput, int iInputStep,
+            float* oOutput, int iOutputStride, int iNFrames
+        );
+        void forward(
+            float* ioData, int iStride,
+            float* oOutput, int iOutputStride, int iNFrames
+        );
+        void activate(const Layer& iLayer, float* ioData);
+    };
+}
+
+#endif /* NEURALNET_H */
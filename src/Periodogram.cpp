@@ -6,6 +6,7 @@
  */
 
 #include <cmath>
+#include <algorithm>
 
 #include "Periodogram.h"
 
@@ -16,14 +17,18 @@ Tracter::Periodogram::Periodogram(
 {
     mObjectName = iObjectName;
     mInput = iInput;
-    Connect(mInput);
+    mBatch = GetEnv("Batch", 1);
+    if (mBatch < 1)
+        throw Exception("%s: Batch must be positive", mObjectName);
+    mAsync = (mBatch > 1);
+    Connect(mInput, mBatch);
 
     int frameSize = mInput->Frame().size;
     mFrame.size = frameSize/2+1;
 
     mRealData = 0;
     mComplexData = 0;
-    mFourier.Init(frameSize, &mRealData, &mComplexData);
+    mFourier.Init(frameSize, &mRealData, &mComplexData, mBatch);
 
     if (GetEnv("Window", 1))
         mWindow = new Window(mObjectName, frameSize);
@@ -37,6 +42,15 @@ Tracter::Periodogram::~Periodogram() throw ()
     mWindow = 0;
 }
 
+/**
+ * When batching, the cache holds up to Batch-1 frames beyond the last
+ * one asked for.
+ */
+void Tracter::Periodogram::Resize(SizeType iSize)
+{
+    CachedComponent<float>::Resize(mAsync ? iSize + mBatch : iSize);
+}
+
 bool Tracter::Periodogram::UnaryFetch(IndexType iIndex, float* oData)
 {
     assert(iIndex >= 0);
@@ -45,23 +59,85 @@ bool Tracter::Periodogram::UnaryFetch(IndexType iIndex, float* oData)
     const float* p = mInput->UnaryRead(iIndex);
     if (!p)
         return false;
+    window(p, mRealData);
+
+    // Do the DFT
+    mFourier.Transform();
+
+    // Compute periodogram
+    power(mComplexData, oData);
+    return true;
+}
+
+/**
+ * Batched fetch.  Whole batches are calculated from the head of the
+ * cache onwards until the requested range is covered; the head and
+ * tail are maintained here rather than by Read().
+ */
+Tracter::SizeType Tracter::Periodogram::Fetch(
+    IndexType iIndex, CacheArea& iOutputArea
+)
+{
+    if (!mAsync)
+        return CachedComponent<float>::Fetch(iIndex, iOutputArea);
 
+    CachePointer& head = mCluster[0].head;
+    CachePointer& tail = mCluster[0].tail;
+    if (iIndex != head.index)
+    {
+        // Read() is starting the cache again
+        head.index = iIndex;
+        head.offset = 0;
+        tail = head;
+    }
+
+    int inSize = mInput->Frame().size;
+    IndexType end = iIndex + iOutputArea.Length();
+    while (head.index < end)
+    {
+        // Window a batch of input frames into the transform input
+        CacheArea inputArea;
+        SizeType got = mInput->Read(inputArea, head.index, mBatch);
+        if (!got)
+            break;
+        const float* p = mInput->GetPointer(inputArea.offset);
+        for (SizeType i=0; i<inputArea.len[0]; i++)
+            window(p + i*inSize, mRealData + i*inSize);
+        p = mInput->GetPointer(0);
+        for (SizeType i=0; i<inputArea.len[1]; i++)
+            window(p + i*inSize, mRealData + (inputArea.len[0]+i)*inSize);
+
+        mFourier.Transform(got);
+
+        for (SizeType i=0; i<got; i++)
+        {
+            power(mComplexData + i*mFrame.size, GetPointer(head.offset));
+            MovePointer(head, 1);
+        }
+        if (head.index - tail.index > mSize)
+            MovePointer(tail, head.index - tail.index - mSize);
+        if (got < mBatch)
+            break;
+    }
+
+    return std::max(std::min(head.index, end) - iIndex, (IndexType)0);
+}
+
+void Tracter::Periodogram::window(const float* iFrame, float* oData)
+{
     if (mWindow)
         // Copy the frame via the window
-        mWindow->Apply(p, mRealData);
+        mWindow->Apply(iFrame, oData);
     else
         // Raw copy
         for (int i=0; i<mInput->Frame().size; i++)
-            mRealData[i] = p[i];
-
-    // Do the DFT
-    mFourier.Transform();
+            oData[i] = iFrame[i];
+}
 
-    // Compute periodogram
+void Tracter::Periodogram::power(const complex* iData, float* oData)
+{
     for (int i=0; i<mFrame.size; i++)
         oData[i] =
-            mComplexData[i].real() * mComplexData[i].real() +
-            mComplexData[i].imag() * mComplexData[i].imag();
-
-    return true;
+            iData[i].real() * iData[i].real() +
+            iData[i].imag() * iData[i].imag();
 }
@@ -18,6 +18,12 @@ namespace Tracter
      * Calculate a periodogram (aka power spectral density).  A window
      * is included; the windowing is beneficial in that it is done
      * during a copy from cache memory to aligned memory.
+     *
+     * If Batch is greater than one, that many frames are transformed
+     * in one call to the Fourier transform.  The cache is then filled
+     * asynchronously, so up to Batch-1 frames are calculated before
+     * they are asked for.  This adds that much latency, but has no
+     * effect on the output values.
      */
     class Periodogram : public CachedComponent<float>
     {
@@ -28,13 +34,19 @@ namespace Tracter
 
     protected:
         bool UnaryFetch(IndexType iIndex, float* oData);
+        SizeType Fetch(IndexType iIndex, CacheArea& iOutputArea);
+        void Resize(SizeType iSize);
 
     private:
         Component<float>* mInput;
+        int mBatch;
         float* mRealData;
         complex* mComplexData;
         Window* mWindow;
         Fourier mFourier;
+
+        void window(const float* iFrame, float* oData);
+        void power(const complex* iData, float* oData);
     };
 }
 
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <algorithm>
+
+#include "PushSink.h"
+
+Tracter::PushSink::PushSink(
+    PushSource* iSource,
+    Component<float>* iInput,
+    PushHandler* iHandler,
+    const char* iObjectName
+)
+{
+    mObjectName = iObjectName;
+    assert(iSource);
+    assert(iHandler);
+    mSource = iSource;
+    mInput = iInput;
+    mHandler = iHandler;
+    Connect(mInput);
+    mFrame.size = mInput->Frame().size;
+    Initialise();
+    Reset();
+
+    // From here on, the Sink destructor deletes the graph
+    if (!mSource->Streamable())
+        throw Exception("%s: graph cannot be driven by push", mObjectName);
+    mIndex = 0;
+    mPeriod = ExactFrameRate().period;
+    mReadAhead = mSource->ReadAhead();
+    mReadBehind = mSource->ReadBehind();
+    mEndOfStream = false;
+    mOutputDone = false;
+
+    // The source cache must span the graph's reach plus one block
+    SizeType block = GetEnv("BlockSize", 1024);
+    mSource->Reserve(mReadAhead + mReadBehind + (SizeType)mPeriod + 1 + block);
+    Verbose(1, "period %.1f read-ahead %ld read-behind %ld\n",
+            mPeriod, mReadAhead, mReadBehind);
+}
+
+/**
+ * Append data to the source and hand over the frames that it makes
+ * computable.  Long buffers are appended in pieces, as the cache
+ * allows.  If the graph has already produced its last frame, the data
+ * is discarded.
+ *
+ * @returns the number of frames passed to the handler.
+ */
+Tracter::SizeType Tracter::PushSink::Push(const float* iData, SizeType iLength)
+{
+    if (mEndOfStream)
+        throw Exception("%s: Push() after EndOfStream()", mObjectName);
+
+    int arraySize = mSource->Frame().size == 0 ? 1 : mSource->Frame().size;
+    SizeType nFrames = 0;
+    while ((iLength > 0) && !mOutputDone)
+    {
+        // Data that no frame yet to be computed can read is free
+        IndexType needed = (IndexType)(mIndex * mPeriod) - mReadBehind;
+        IndexType oldest = std::max(needed, (IndexType)0);
+        SizeType room = mSource->Size() - (mSource->Available() - oldest);
+        if (room <= 0)
+            throw Exception("%s: source cache is full", mObjectName);
+        SizeType len = std::min(room, iLength);
+        mSource->Append(iData, len);
+        iData += len * arraySize;
+        iLength -= len;
+        nFrames += produce();
+    }
+    return nFrames;
+}
+
+/**
+ * Signal that there is no more data, and hand over the remaining
+ * frames.
+ *
+ * @returns the number of frames passed to the handler.
+ */
+Tracter::SizeType Tracter::PushSink::EndOfStream()
+{
+    mEndOfStream = true;
+    mSource->EndOfStream();
+    return produce();
+}
+
+/**
+ * Read every frame that the data so far allows.
+ */
+Tracter::SizeType Tracter::PushSink::produce()
+{
+    SizeType nFrames = 0;
+    while (!mOutputDone)
+    {
+        if (!mEndOfStream &&
+            ((IndexType)(mIndex * mPeriod) + mReadAhead >=
+             mSource->Available()))
+            break;
+        CacheArea ca;
+        if (!mInput->Read(ca, mIndex))
+        {
+            mOutputDone = true;
+            Verbose(1, "%lld frames\n", mIndex);
+            break;
+        }
+        mHandler->Frame(mIndex, mInput->GetPointer(ca.offset));
+        mIndex++;
+        nFrames++;
+    }
+    return nFrames;
+}
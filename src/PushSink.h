@@ -0,0 +1,77 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#ifndef PUSHSINK_H
+#define PUSHSINK_H
+
+#include "Sink.h"
+#include "PushSource.h"
+
+namespace Tracter
+{
+    /**
+     * Receives the frames computed by a PushSink.
+     */
+    class PushHandler
+    {
+    public:
+        virtual ~PushHandler() {}
+
+        /** Called once per output frame, in order */
+        virtual void Frame(IndexType iIndex, const float* iFrame) = 0;
+    };
+
+    /**
+     * Incremental driver for a graph fed by a PushSource.
+     *
+     * The application calls Push() with whatever data it has, e.g.,
+     * from an audio callback.  Push() appends it to the source and
+     * passes every output frame that has become computable, given
+     * the read-ahead of the graph, to the handler before returning.
+     * EndOfStream() flushes the frames at the end.  The caches are
+     * sized once by the constructor, so there is no allocation per
+     * call.
+     *
+     * Front-ends that contain variable rate components (gates) or
+     * that need the whole stream (e.g., static mean normalisation)
+     * cannot be driven this way.
+     */
+    class PushSink : public Sink
+    {
+    public:
+        PushSink(
+            PushSource* iSource,
+            Component<float>* iInput,
+            PushHandler* iHandler,
+            const char* iObjectName = "PushSink"
+        );
+        virtual ~PushSink() throw () {}
+
+        SizeType Push(const float* iData, SizeType iLength);
+        SizeType EndOfStream();
+
+        /** Number of frames passed to the handler so far */
+        IndexType Index() const { return mIndex; }
+
+        /** True once the last frame has been passed to the handler */
+        bool Done() const { return mOutputDone; }
+
+    private:
+        PushSource* mSource;
+        Component<float>* mInput;
+        PushHandler* mHandler;
+        IndexType mIndex;
+        double mPeriod;
+        SizeType mReadAhead;
+        SizeType mReadBehind;
+        bool mEndOfStream;
+        bool mOutputDone;
+
+        SizeType produce();
+    };
+}
+
+#endif /* PUSHSINK_H */
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <cstring> // For memcpy()
+#include <algorithm>
+
+#include "PushSource.h"
+
+Tracter::PushSource::PushSource(const char* iObjectName)
+{
+    mObjectName = iObjectName;
+    mFrameRate = GetEnv("FrameRate", 8000.0f);
+    mFrame.size = GetEnv("FrameSize", 1);
+    mAsync = true;
+    mEndOfStream = false;
+    MinSize(this, SecondsToFrames(GetEnv("BufferTime", 1.0f)));
+}
+
+/**
+ * Copy new frames into the cache.  The caller must make sure that
+ * there is room; i.e., that frames not yet consumed are not
+ * overwritten.
+ */
+void Tracter::PushSource::Append(const float* iData, SizeType iLength)
+{
+    assert(iLength <= mSize);
+    CachePointer& head = mCluster[0].head;
+    CachePointer& tail = mCluster[0].tail;
+    int arraySize = mFrame.size == 0 ? 1 : mFrame.size;
+    SizeType done = 0;
+    while (done < iLength)
+    {
+        SizeType len = std::min(iLength - done, mSize - head.offset);
+        memcpy(GetPointer(head.offset), iData + done * arraySize,
+               len * arraySize * sizeof(float));
+        MovePointer(head, len);
+        done += len;
+    }
+    if (head.index - tail.index > mSize)
+        MovePointer(tail, head.index - tail.index - mSize);
+}
+
+Tracter::SizeType
+Tracter::PushSource::Fetch(IndexType iIndex, CacheArea& iOutputArea)
+{
+    assert(iIndex >= 0);
+    IndexType available = Available();
+    SizeType len = iOutputArea.Length();
+    if (iIndex + len <= available)
+        return len;
+    if (!mEndOfStream)
+        throw Exception("%s: data for index %lld requested before arrival",
+                        mObjectName, iIndex + len - 1);
+    return (SizeType)std::max(available - iIndex, (IndexType)0);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#ifndef PUSHSOURCE_H
+#define PUSHSOURCE_H
+
+#include "CachedComponent.h"
+#include "Source.h"
+
+namespace Tracter
+{
+    /**
+     * Source that is filled by the application rather than fetching
+     * its own data.  The cache is written directly by Append();
+     * Fetch() only ever reports what is already there.
+     *
+     * Normally driven by a PushSink, which makes sure that the graph
+     * never asks for data that has not yet arrived.
+     */
+    class PushSource : public Source< CachedComponent<float> >
+    {
+    public:
+        PushSource(const char* iObjectName = "PushSource");
+        virtual ~PushSource() throw () {}
+
+        void Open(const char* iName, TimeType iBeginTime, TimeType iEndTime)
+        {
+            throw Exception("%s: Open() not supported", mObjectName);
+        }
+
+        /** Frames read ahead of a frame's first frame by the graph */
+        SizeType ReadAhead() const { return mTotalReadAhead + mMaxReadAhead; }
+
+        /** Frames read behind a frame's first frame by the graph */
+        SizeType ReadBehind() const
+        {
+            return mTotalReadBehind + mMaxReadBehind;
+        }
+
+        /** False if the graph needs data that will never arrive */
+        bool Streamable() const { return !mIndefinite && ReadAhead() >= 0; }
+
+        /** Index one past the last frame appended */
+        IndexType Available() const { return mCluster[0].head.index; }
+
+        SizeType Size() const { return mSize; }
+
+        /** Enlarge the cache; only valid before any data is appended */
+        void Reserve(SizeType iSize)
+        {
+            assert(Available() == 0);
+            if (iSize > mSize)
+                Resize(iSize);
+        }
+
+        void Append(const float* iData, SizeType iLength);
+
+        /** Flag that no more data will be appended */
+        void EndOfStream() { mEndOfStream = true; }
+
+    protected:
+        SizeType Fetch(IndexType iIndex, CacheArea& iOutputArea);
+
+    private:
+        bool mEndOfStream;
+    };
+}
+
+#endif /* PUSHSOURCE_H */
@@ -0,0 +1,234 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <cmath>
+
+#include "Kernel.h"
+#include "Resample.h"
+
+namespace Tracter
+{
+    /** Greatest common divisor */
+    static long gcd(long iA, long iB)
+    {
+        while (iB)
+        {
+            long t = iA % iB;
+            iA = iB;
+            iB = t;
+        }
+        return iA;
+    }
+
+    /** Zeroth order modified Bessel function of the first kind */
+    static double bessel0(double iX)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        double x = iX * iX / 4.0;
+        for (int k=1; term > sum * 1e-12; k++)
+        {
+            term *= x / ((double)k * k);
+            sum += term;
+        }
+        return sum;
+    }
+}
+
+/**
+ * Initialise a sample rate converter.  Environment variables:
+ *  - TargetRate (16000)  Target sample frequency.
+ *  - ZeroCrossings (16)  Half length of the filter in zero crossings
+ *                        of the lower of the two rates.
+ *  - Rolloff (0.9)       Cut-off as a fraction of the lower Nyquist.
+ *  - Beta (8)            Kaiser window parameter.
+ */
+Tracter::Resample::Resample(
+    Component<float>* iInput, const char* iObjectName
+)
+{
+    mObjectName = iObjectName;
+    mInput = iInput;
+
+    long inputRate = (long)(mInput->FrameRate() + 0.5f);
+    long targetRate = (long)(GetEnv("TargetRate", 16000.0f) + 0.5f);
+    if ((inputRate <= 0) || (targetRate <= 0))
+        throw Exception("%s: Can't convert from %ld Hz to %ld Hz",
+                        mObjectName, inputRate, targetRate);
+    long g = gcd(inputRate, targetRate);
+    mUp = (int)(targetRate / g);
+    mDown = (int)(inputRate / g);
+    mFrame.period = (float)mDown / mUp;
+
+    /*
+     * The prototype filter runs at mUp times the input rate, so its
+     * cut-off in cycles per sample is half over the larger factor.
+     * The gain is mUp to make up for the zeros that the interpolation
+     * would insert.
+     */
+    int zeroCrossings = GetEnv("ZeroCrossings", 16);
+    float rolloff = GetEnv("Rolloff", 0.9f);
+    float beta = GetEnv("Beta", 8.0f);
+    int factor = std::max(mUp, mDown);
+    double cutoff = rolloff * 0.5 / factor;
+    mHalf = zeroCrossings * factor;
+    mNTaps = (2 * mHalf + mUp) / mUp;
+    mStride = Kernel::Pad(mNTaps);
+
+    /*
+     * Phase p holds taps p, p+L, p+2L... of the prototype.  Each phase
+     * is stored time reversed, and padded at the front, so it lines
+     * up with the mStride input samples that end at last().
+     */
+    mBank = Kernel::Allocate(mUp * mStride);
+    double norm = bessel0(beta);
+    for (int p=0; p<mUp; p++)
+    {
+        float* phase = mBank + p * mStride;
+        for (int k=0; k<mStride; k++)
+            phase[k] = 0.0f;
+        for (int k=0; k<mNTaps; k++)
+        {
+            int j = p + k * mUp;
+            if (j > 2 * mHalf)
+                break;
+            double t = j - mHalf;
+            double x = 2.0 * cutoff * t;
+            double sinc = (t == 0) ? 1.0 : sin(M_PI * x) / (M_PI * x);
+            double r = t / mHalf;
+            double w = bessel0(beta * sqrt(std::max(0.0, 1.0 - r*r))) / norm;
+            phase[mStride - 1 - k] = (float)(2.0 * cutoff * mUp * sinc * w);
+        }
+    }
+
+    // The size is somewhat minimum; it is likely to be increased later
+    Connect(mInput, mStride + mDown / mUp + 1);
+    Verbose(1, "ratio %d/%d, %d taps per phase\n", mUp, mDown, mNTaps);
+}
+
+Tracter::Resample::~Resample() throw()
+{
+    Kernel::Free(mBank);
+    mBank = 0;
+}
+
+/**
+ * Ensures that the input component has the right size given the rate
+ * conversion
+ */
+void Tracter::Resample::MinSize(
+    SizeType iSize, SizeType iReadBehind, SizeType iReadAhead
+)
+{
+    // First call the base class to resize this cache
+    assert(iSize > 0);
+    ComponentBase::MinSize(iSize, iReadBehind, iReadAhead);
+
+    // Set the input buffer big enough to service largest output
+    // requests; last() can step by M/L rounded either way
+    assert(mInput);
+    SizeType minSize =
+        (SizeType)(((IndexType)iSize - 1) * mDown + mUp - 1) / mUp + mStride;
+    ComponentBase::MinSize(mInput, minSize, mStride, 0);
+}
+
+/**
+ * Index of the newest input sample that contributes to output iIndex.
+ * The oldest is mStride - 1 before it.
+ */
+Tracter::IndexType Tracter::Resample::last(IndexType iIndex) const
+{
+    return (iIndex * mDown + mHalf) / mUp;
+}
+
+Tracter::SizeType
+Tracter::Resample::Fetch(IndexType iIndex, CacheArea& iOutputArea)
+{
+    assert(iOutputArea.Length() > 0);
+    assert(iIndex >= 0);
+
+    /* The input range for the whole output area */
+    SizeType len = iOutputArea.Length();
+    IndexType lo = last(iIndex) - mStride + 1;
+    IndexType hi = last(iIndex + len - 1);
+    IndexType index = std::max(lo, (IndexType)0);
+    SizeType nGet = (SizeType)(hi - index + 1);
+    CacheArea inputArea;
+    SizeType nGot = mInput->Read(inputArea, index, nGet);
+    Verbose(3, "i=%ld lo=%ld Get=%d Got=%d len0=%d len1=%d\n",
+            iIndex, lo, nGet, nGot, inputArea.len[0], inputArea.len[1]);
+
+    /*
+     * Output n exists if its time, n * M / L, is before the end of
+     * the input.
+     */
+    SizeType nOut = len;
+    if (nGot < nGet)
+    {
+        IndexType end = index + nGot;
+        IndexType nTotal = (end * mUp + mDown - 1) / mDown;
+        nOut = (SizeType)std::max(
+            (IndexType)0, std::min((IndexType)len, nTotal - iIndex)
+        );
+    }
+    if (nOut == 0)
+        return 0;
+
+    /*
+     * Use the input in place if we can, otherwise gather it into a
+     * buffer padded with zeros either side.
+     */
+    const float* input;
+    if ((lo >= 0) && (nGot == nGet) && (inputArea.len[1] == 0))
+        input = mInput->GetPointer(inputArea.offset);
+    else
+    {
+        SizeType size = (SizeType)(hi - lo + 1);
+        if (mBuffer.size() < (size_t)size)
+            mBuffer.resize(size);
+        float* buffer = &mBuffer[0];
+        SizeType b = 0;
+        for (; b < index - lo; b++)
+            buffer[b] = 0.0f;
+        const float* p = mInput->GetPointer(inputArea.offset);
+        for (SizeType i=0; i<inputArea.len[0]; i++)
+            buffer[b++] = p[i];
+        p = mInput->GetPointer();
+        for (SizeType i=0; i<inputArea.len[1]; i++)
+            buffer[b++] = p[i];
+        for (; b < size; b++)
+            buffer[b] = 0.0f;
+        input = buffer;
+    }
+
+    /*
+     * Step through the phases; the first input sample advances by M/L
+     * per output, and the phase by the remainder.
+     */
+    IndexType u = iIndex * mDown + mHalf;
+    SizeType start = (SizeType)(u / mUp - mStride + 1 - lo);
+    int phase = (int)(u % mUp);
+    int step = mDown / mUp;
+    int remainder = mDown % mUp;
+    float* output = GetPointer(iOutputArea.offset);
+    for (SizeType i=0; i<nOut; i++)
+    {
+        if (i == iOutputArea.len[0])
+            output = GetPointer() - i;
+        output[i] = Kernel::DotAligned(
+            mBank + phase * mStride, input + start, mStride
+        );
+        start += step;
+        phase += remainder;
+        if (phase >= mUp)
+        {
+            phase -= mUp;
+            start++;
+        }
+    }
+
+    return nOut;
+}
@@ -8,22 +8,20 @@
 #ifndef RESAMPLE_H
 #define RESAMPLE_H
 
-#include "CachedComponent.h"
+#include <vector>
 
-#ifdef HAVE_LIBRESAMPLE
-# define HAVE_RESAMPLE = 1
-#endif
+#include "CachedComponent.h"
 
 namespace Tracter
 {
-    /**
-     * Implementation specific data
-     */
-    struct ResampleData;
-
     /**
      * Resample or convert sample rate.
-     * Currently tied to libresample
+     *
+     * A polyphase FIR resampler.  The input and target rates are
+     * rounded to integers and their ratio reduced to L/M.  The filter
+     * is a Kaiser windowed sinc at L times the input rate, split into
+     * L phases when the component is constructed.  Each output sample
+     * is then a single dot product of one phase with the input.
      */
     class Resample : public CachedComponent<float>
     {
@@ -31,15 +29,29 @@ namespace Tracter
         Resample(Component<float>* iInput,
                  const char* iObjectName = "Resample");
         virtual ~Resample() throw();
-        void Reset(bool iPropagate = true);
         void MinSize(SizeType iSize, SizeType iReadBehind, SizeType iReadAhead);
 
     protected:
         SizeType Fetch(IndexType iIndex, CacheArea& iOutputArea);
 
+        void DotHook()
+        {
+            CachedComponent<float>::DotHook();
+            DotRecord(1, "ratio=%d/%d", mUp, mDown);
+            DotRecord(1, "taps=%d", mNTaps);
+        }
+
     private:
         Component<float>* mInput;
-        ResampleData *mResampleData;
+        int mUp;                    ///< Interpolation factor, L
+        int mDown;                  ///< Decimation factor, M
+        int mHalf;                  ///< Half length of the prototype filter
+        int mNTaps;                 ///< Taps per phase
+        int mStride;                ///< Taps per phase, padded
+        float* mBank;               ///< The phases, time reversed
+        std::vector<float> mBuffer; ///< Input that can't be used in place
+
+        IndexType last(IndexType iIndex) const;
     };
 }
 
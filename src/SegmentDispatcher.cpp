@@ -0,0 +1,215 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <cstdio>
+
+#include "SegmentDispatcher.h"
+#include "FilePath.h"
+#include "Frame.h"
+#include "Energy.h"
+#include "Modulation.h"
+#include "Minima.h"
+#include "Comparator.h"
+#include "TimedLatch.h"
+
+Tracter::SegmentDispatcher::SegmentDispatcher(
+    ASRFactory* iFactory, const char* iObjectName
+)
+{
+    mObjectName = iObjectName;
+    mDone = true;
+
+    /* The control graph; the same VAD as BasicVAD with MinimaVAD */
+    Component<float>* v = iFactory->CreateSource(mSource);
+    v = new Frame(v);
+    v = new Energy(v);
+    Modulation* m = new Modulation(v);
+    Component<float>* n = new Minima(v);
+    Component<BoolType>* b = new Comparator(m, n);
+    b = new TimedLatch(b);
+    mControl = new FrameSink<BoolType>(b);
+
+    /*
+     * The worker graphs.  They are all built here rather than in the
+     * threads as construction isn't thread safe (FFT plans, for
+     * instance).
+     */
+    int workers = GetEnv("Workers", 4);
+    if (workers < 1)
+        throw Exception("%s: Workers must be positive", mObjectName);
+    for (int i=0; i<workers; i++)
+        mWorker.push_back(new Worker(this, iFactory));
+}
+
+Tracter::SegmentDispatcher::~SegmentDispatcher() throw ()
+{
+    for (int i=0; i<(int)mWorker.size(); i++)
+        delete mWorker[i];
+    delete mControl;
+}
+
+/**
+ * Segment the file iInput, and extract each segment in a worker.
+ * Returns when all the segments have been written.
+ */
+void Tracter::SegmentDispatcher::File(const char* iInput, const char* iOutput)
+{
+    assert(iInput);
+    assert(iOutput);
+    FilePath path;
+    path.SetName(iOutput);
+    path.MakePath();
+    FILE* list = fopen(iOutput, "w");
+    if (!list)
+        throw Exception("%s: Failed to open %s", mObjectName, iOutput);
+
+    mInput = iInput;
+    mOutput = iOutput;
+    mError.clear();
+    mDone = false;
+    for (int i=0; i<(int)mWorker.size(); i++)
+        mWorker[i]->Start();
+
+    /* Run the VAD, dispatching each segment as soon as it closes */
+    std::vector<Segment> segment;
+    try
+    {
+        mControl->Reset();
+        mSource->Open(iInput);
+        IndexType begin = -1;
+        IndexType index = 0;
+        const BoolType* open;
+        while ((open = mControl->Read(index)))
+        {
+            if (*open && (begin < 0))
+                begin = index;
+            if (!*open && (begin >= 0))
+            {
+                segment.push_back(dispatch(segment.size(), begin, index));
+                begin = -1;
+            }
+            index++;
+        }
+        if (begin >= 0)
+            segment.push_back(dispatch(segment.size(), begin, index));
+    }
+    catch (std::exception& e)
+    {
+        fail(e.what());
+    }
+
+    /* Let the workers finish the queue */
+    mMutex.Lock();
+    mDone = true;
+    mCondition.Broadcast();
+    mMutex.Unlock();
+    for (int i=0; i<(int)mWorker.size(); i++)
+        mWorker[i]->Join();
+    if (!mError.empty())
+    {
+        fclose(list);
+        throw Exception("%s: %s", mObjectName, mError.c_str());
+    }
+
+    /* The list, in order whatever order the workers finished in */
+    for (int i=0; i<(int)segment.size(); i++)
+        fprintf(list, "%s.%d %.3f %.3f\n", iOutput, i,
+                segment[i].begin * 1.0e-9, segment[i].end * 1.0e-9);
+    fclose(list);
+    Verbose(1, "%d segments\n", (int)segment.size());
+}
+
+/**
+ * Queue the segment from frame iBegin up to but not including iEnd
+ */
+Tracter::SegmentDispatcher::Segment Tracter::SegmentDispatcher::dispatch(
+    int iNumber, IndexType iBegin, IndexType iEnd
+)
+{
+    Segment segment;
+    segment.number = iNumber;
+    TimeType zero = mControl->TimeStamp(0);
+    segment.begin = mControl->TimeStamp(iBegin) - zero;
+    segment.end = mControl->TimeStamp(iEnd) - zero;
+    Verbose(1, "segment %d: %.3f to %.3f\n",
+            iNumber, segment.begin * 1.0e-9, segment.end * 1.0e-9);
+
+    mMutex.Lock();
+    mQueue.push_back(segment);
+    mCondition.Signal();
+    mMutex.Unlock();
+    return segment;
+}
+
+/**
+ * Called by the workers to get the next segment.  Waits if the queue
+ * is empty but more may come.  Returns false when there's no more
+ * work.
+ */
+bool Tracter::SegmentDispatcher::next(Segment& oSegment)
+{
+    mMutex.Lock();
+    while (mQueue.empty() && !mDone)
+        mCondition.Wait(mMutex);
+    bool got = !mQueue.empty() && mError.empty();
+    if (got)
+    {
+        oSegment = mQueue.front();
+        mQueue.pop_front();
+    }
+    mMutex.Unlock();
+    return got;
+}
+
+/**
+ * Called by the workers to record an error; the first one is thrown
+ * by File() once all the workers have stopped.
+ */
+void Tracter::SegmentDispatcher::fail(const char* iMessage)
+{
+    mMutex.Lock();
+    if (mError.empty())
+        mError = iMessage;
+    mMutex.Unlock();
+}
+
+Tracter::SegmentDispatcher::Worker::Worker(
+    SegmentDispatcher* iDispatcher, ASRFactory* iFactory
+)
+{
+    mDispatcher = iDispatcher;
+    Component<float>* s = iFactory->CreateSource(mSource);
+    Component<float>* f = iFactory->CreateFrontend(s);
+    mSink = new HTKSink(f);
+}
+
+Tracter::SegmentDispatcher::Worker::~Worker() throw ()
+{
+    delete mSink;
+}
+
+void Tracter::SegmentDispatcher::Worker::start()
+{
+    Segment segment;
+    while (mDispatcher->next(segment))
+    {
+        char file[1024];
+        snprintf(file, 1024, "%s.%d",
+                 mDispatcher->mOutput.c_str(), segment.number);
+        try
+        {
+            mSink->Reset();
+            mSource->Open(
+                mDispatcher->mInput.c_str(), segment.begin, segment.end
+            );
+            mSink->Open(file);
+        }
+        catch (std::exception& e)
+        {
+            mDispatcher->fail(e.what());
+        }
+    }
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#ifndef SEGMENTDISPATCHER_H
+#define SEGMENTDISPATCHER_H
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "ASRFactory.h"
+#include "FrameSink.h"
+#include "HTKSink.h"
+#include "Thread.h"
+
+namespace Tracter
+{
+    /**
+     * Segment dispatcher.
+     *
+     * Runs a minima based VAD (as BasicVAD with MinimaVAD set) over a
+     * whole file, and hands each speech segment to a pool of Workers
+     * threads as soon as it is found.  Each worker has its own source
+     * and front-end from the factory, and opens the file over just the
+     * segment's time range.  For file sources the file is memory
+     * mapped, so the workers share the data.  The front-end should be
+     * ungated (e.g., Basic); each segment is extracted as if it were
+     * an utterance of its own.
+     *
+     * Segment n of output is written to output.n in HTK format, and
+     * output itself gets a line per segment of file name, start time
+     * and end time in seconds.
+     */
+    class SegmentDispatcher : public Object
+    {
+    public:
+        SegmentDispatcher(
+            ASRFactory* iFactory, const char* iObjectName = "SegmentDispatcher"
+        );
+        virtual ~SegmentDispatcher() throw ();
+        void File(const char* iInput, const char* iOutput);
+
+    private:
+        /** A segment as times from the start of the file */
+        struct Segment
+        {
+            int number;
+            TimeType begin;
+            TimeType end;
+        };
+
+        /** A thread with its own graph */
+        class Worker : public Thread
+        {
+        public:
+            Worker(SegmentDispatcher* iDispatcher, ASRFactory* iFactory);
+            virtual ~Worker() throw ();
+            void start();
+
+        private:
+            SegmentDispatcher* mDispatcher;
+            ISource* mSource;
+            HTKSink* mSink;
+        };
+
+        ISource* mSource;
+        FrameSink<BoolType>* mControl;
+        std::vector<Worker*> mWorker;
+
+        Mutex mMutex;
+        Condition mCondition;
+        std::deque<Segment> mQueue;
+        bool mDone;
+        std::string mInput;
+        std::string mOutput;
+        std::string mError;
+
+        Segment dispatch(int iNumber, IndexType iBegin, IndexType iEnd);
+        bool next(Segment& oSegment);
+        void fail(const char* iMessage);
+    };
+}
+
+#endif /* SEGMENTDISPATCHER_H */
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <algorithm>
+
+#include "SharedMemorySink.h"
+
+Tracter::SharedMemorySink::SharedMemorySink(
+    Component<float>* iInput,
+    const char* iObjectName
+)
+    : mRing(iObjectName)
+{
+    mObjectName = iObjectName;
+    mInput = iInput;
+
+    float flushTime = GetEnv("FlushTime", 0.01f);
+    float frameRate = mInput->FrameRate() / mInput->Frame().period;
+    SizeType flushFrames = (SizeType)(flushTime * frameRate);
+    mBatch = std::max(
+        std::min((SizeType)GetEnv("BatchSize", 1024), flushFrames),
+        (SizeType)1
+    );
+    Connect(mInput, mBatch);
+
+    mFrame.size = mInput->Frame().size;
+    Initialise();
+    Reset();
+
+    const char* name = GetEnv("Name", "/tracter");
+    float bufferTime = GetEnv("BufferTime", 1.0f);
+    IndexType capacity = std::max(
+        (IndexType)SecondsToFrames(bufferTime), (IndexType)mBatch
+    );
+    mRing.Spin(GetEnv("Spin", 1000));
+    mRing.Create(name, mFrame.size, FrameRate(), TimeStamp(),
+                 capacity);
+    Verbose(1, "created %s with %lld frames\n", name, capacity);
+}
+
+Tracter::SharedMemorySink::~SharedMemorySink() throw()
+{
+}
+
+void Tracter::SharedMemorySink::Pull()
+{
+    CacheArea ca;
+    IndexType index = 0;
+    SizeType got;
+    while ((got = mInput->Read(ca, index, mBatch)) > 0)
+    {
+        mRing.Write(mInput->GetPointer(ca.offset), ca.len[0]);
+        mRing.Write(mInput->GetPointer(0), ca.len[1]);
+        Verbose(2, "Wrote %ld frames at %lld\n", got, index);
+        index += got;
+        if (got < mBatch)
+            break;
+    }
+    mRing.EndOfData();
+}
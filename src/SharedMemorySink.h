@@ -0,0 +1,46 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#ifndef SHAREDMEMORYSINK_H
+#define SHAREDMEMORYSINK_H
+
+#include "Component.h"
+#include "Sink.h"
+#include "SharedRing.h"
+
+namespace Tracter
+{
+    /**
+     * Sinks to a ring buffer in POSIX shared memory.
+     *
+     * This is the local counterpart of SocketSink.  The ring (named
+     * by Name, and BufferTime seconds long) is created by the
+     * constructor and carries the frame size, rate and time stamp in
+     * its header, so the sink must be created before any
+     * SharedMemorySource opens it.  Frames are copied in batches as
+     * for SocketSink; Pull() blocks while the ring is full.  The
+     * ring is removed when the sink is destroyed, so a consumer must
+     * attach before then; one that has attached reads the stream to
+     * the end.
+     */
+    class SharedMemorySink : public Sink
+    {
+    public:
+        SharedMemorySink(
+            Component<float>* iInput,
+            const char* iObjectName = "SharedMemorySink"
+        );
+        virtual ~SharedMemorySink() throw();
+        void Pull();
+
+    private:
+        Component<float>* mInput;
+        SizeType mBatch;
+        SharedRing mRing;
+    };
+}
+
+#endif /* SHAREDMEMORYSINK_H */
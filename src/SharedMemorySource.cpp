@@ -0,0 +1,113 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include "SharedMemorySource.h"
+
+Tracter::SharedMemorySource::SharedMemorySource(const char* iObjectName)
+{
+    mObjectName = iObjectName;
+    mFrameRate = GetEnv("FrameRate", 8000.0f);
+    mFrame.size = GetEnv("FrameSize", 1);
+    mFrame.period = 1;
+    mFrameFloats = (mFrame.size == 0) ? 1 : mFrame.size;
+    mRing = 0;
+    mRequired = 1;
+    mSize = 0;
+    mAsync = true;
+}
+
+Tracter::SharedMemorySource::~SharedMemorySource() throw ()
+{
+    delete mRing;
+}
+
+void Tracter::SharedMemorySource::Open(
+    const char* iName,
+    TimeType iBeginTime,
+    TimeType iEndTime
+)
+{
+    if (mIndefinite)
+        throw Exception("%s: cannot supply an indefinite cache", mObjectName);
+
+    delete mRing;
+    mRing = 0;
+    mRing = new SharedRing(mObjectName);
+    mRing->Spin(GetEnv("Spin", 1000));
+    mRing->Attach(iName, GetEnv("AttachTimeout", 1.0f));
+
+    const SharedRingHeader& header = mRing->Header();
+    if (header.frameSize != mFrame.size)
+        throw Exception("%s: %s has frame size %d, expected %d",
+                        mObjectName, iName, header.frameSize, mFrame.size);
+    if (fabsf(header.frameRate - mFrameRate) > 1e-3f * mFrameRate)
+        throw Exception("%s: %s has frame rate %f, expected %f",
+                        mObjectName, iName, header.frameRate, mFrameRate);
+    // One cache to keep and one to fetch into
+    if (header.capacity < 2 * mRequired)
+        throw Exception("%s: %s holds %lld frames, graph needs %ld",
+                        mObjectName, iName, header.capacity, 2 * mRequired);
+    Verbose(1, "attached %s with %lld frames\n", iName, header.capacity);
+
+    // The ring *is* the cache
+    mSize = header.capacity;
+    mTime = header.time;
+    mCluster[0].head.index = 0;
+    mCluster[0].head.offset = 0;
+    mCluster[0].tail.index = 0;
+    mCluster[0].tail.offset = 0;
+}
+
+/**
+ * Just record the size; the ring size is fixed by the producer and
+ * is checked against this on Open().
+ */
+void Tracter::SharedMemorySource::Resize(SizeType iSize)
+{
+    mRequired = std::max(mRequired, iSize);
+}
+
+/**
+ * Wait for the producer, then expose whatever it has written by
+ * moving the head.  Frames older than the cache the graph asked for
+ * are handed back to the producer by moving the tail; this is done
+ * before waiting too, as the producer may be waiting for the space.
+ */
+Tracter::SizeType Tracter::SharedMemorySource::Fetch(
+    IndexType iIndex, CacheArea& iOutputArea
+)
+{
+    assert(mRing);
+    CachePointer& head = mCluster[0].head;
+    if (iIndex != head.index)
+        throw Exception("%s: non-sequential read at %lld, head %lld",
+                        mObjectName, iIndex, head.index);
+
+    IndexType end = iIndex + iOutputArea.Length();
+    release(std::min(head.index, end) - mRequired);
+    IndexType available = mRing->WaitHead(end);
+    head.index = available;
+    head.offset = available % mSize;
+    release(std::min(available, end) - mRequired);
+
+    return std::min(available, end) - iIndex;
+}
+
+/**
+ * Move the tail up to iIndex, releasing the frames before it.
+ */
+void Tracter::SharedMemorySource::release(IndexType iIndex)
+{
+    CachePointer& tail = mCluster[0].tail;
+    if (iIndex <= tail.index)
+        return;
+    tail.index = iIndex;
+    tail.offset = iIndex % mSize;
+    mRing->Release(iIndex);
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#ifndef SHAREDMEMORYSOURCE_H
+#define SHAREDMEMORYSOURCE_H
+
+#include "Component.h"
+#include "Source.h"
+#include "SharedRing.h"
+
+namespace Tracter
+{
+    /**
+     * Source from a shared memory ring written by a SharedMemorySink
+     * in another process.
+     *
+     * As for FileSource, the shared memory *is* the cache, so frames
+     * are never copied.  The ring must be at least twice the size of
+     * the cache the graph asks for; frames are released back to the
+     * producer once they fall out of that cache.  FrameSize and
+     * FrameRate must match the producer, and the time stamp is taken
+     * from the ring header.  Open() waits up to AttachTimeout seconds
+     * for the producer to create the ring.
+     */
+    class SharedMemorySource : public Source< Component<float> >
+    {
+    public:
+        SharedMemorySource(const char* iObjectName = "SharedMemorySource");
+        virtual ~SharedMemorySource() throw ();
+
+        virtual void Open(
+            const char* iName,
+            TimeType iBeginTime = -1,
+            TimeType iEndTime = -1
+        );
+
+        float* GetPointer(SizeType iOffset = 0)
+        {
+            assert(mRing);
+            return mRing->Data() + iOffset * mFrameFloats;
+        }
+
+        virtual void Reset(bool iPropagate)
+        {
+            // Don't call the base class, don't reset the pointers
+            return;
+        }
+
+    private:
+        SharedRing* mRing;
+        SizeType mRequired;
+        int mFrameFloats;
+
+        void Resize(SizeType iSize);
+        virtual SizeType Fetch(IndexType iIndex, CacheArea& iOutputArea);
+        void release(IndexType iIndex);
+    };
+}
+
+#endif /* SHAREDMEMORYSOURCE_H */
@@ -0,0 +1,298 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#ifdef HAVE_LINUX
+# include <time.h>
+# include <sys/syscall.h>
+# include <linux/futex.h>
+#endif
+
+#include "TracterObject.h"
+#include "SharedRing.h"
+
+namespace Tracter
+{
+    const char cSharedRingMagic[8] = "tracter";
+    const int cSharedRingVersion = 1;
+}
+
+/** Round up so the frames start on a cache line */
+static size_t dataOffset()
+{
+    return (sizeof(Tracter::SharedRingHeader) + 63) & ~(size_t)63;
+}
+
+Tracter::SharedRing::SharedRing(const char* iObjectName)
+{
+    mObjectName = iObjectName;
+    mName = 0;
+    mOwner = false;
+    mFD = -1;
+    mMap = 0;
+    mMapSize = 0;
+    mHeader = 0;
+    mData = 0;
+    mFrameBytes = 0;
+    mSpin = 1000;
+}
+
+Tracter::SharedRing::~SharedRing()
+{
+    if (mHeader && !mOwner)
+    {
+        // Don't leave the producer waiting for space
+        mHeader->detached = 1;
+        wake(&mHeader->tailSeq, &mHeader->tailWaiters);
+    }
+    // The producer owns the name; consumers keep their own mapping
+    if (mOwner)
+        shm_unlink(mName);
+    if (mMap)
+        munmap(mMap, mMapSize);
+    if (mFD >= 0)
+        close(mFD);
+    if (mName)
+        free(mName);
+}
+
+/**
+ * Create the shared memory segment and initialise the header.  Any
+ * stale segment of the same name is removed first.  The magic number
+ * is written last so a consumer never sees a partial header.
+ */
+void Tracter::SharedRing::Create(
+    const char* iName, int iFrameSize, float iFrameRate,
+    TimeType iTime, IndexType iCapacity
+)
+{
+    assert(iName);
+    assert(iCapacity > 0);
+    mName = strdup(iName);
+    shm_unlink(mName);
+    mFD = shm_open(mName, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (mFD < 0)
+    {
+        perror(mObjectName);
+        throw Exception("%s: shm_open() failed for %s", mObjectName, mName);
+    }
+    mOwner = true;
+
+    mFrameBytes = ((iFrameSize == 0) ? 1 : iFrameSize) * sizeof(float);
+    size_t size = dataOffset() + iCapacity * mFrameBytes;
+    if (ftruncate(mFD, size) < 0)
+    {
+        perror(mObjectName);
+        throw Exception("%s: ftruncate() failed for %s", mObjectName, mName);
+    }
+    map(size);
+
+    memset(mHeader, 0, sizeof(SharedRingHeader));
+    mHeader->version = cSharedRingVersion;
+    mHeader->frameSize = iFrameSize;
+    mHeader->frameRate = iFrameRate;
+    mHeader->time = iTime;
+    mHeader->capacity = iCapacity;
+    __sync_synchronize();
+    memcpy(mHeader->magic, cSharedRingMagic, sizeof(mHeader->magic));
+}
+
+/**
+ * Attach to a segment created by another process.  The producer may
+ * still be setting the segment up (or not have created it yet), so
+ * this retries for up to iTimeout seconds until the magic number is
+ * written.
+ */
+void Tracter::SharedRing::Attach(const char* iName, float iTimeout)
+{
+    assert(iName);
+    mName = strdup(iName);
+    const int pause = 1000; // us
+    int tries = std::max((int)(iTimeout * 1e6f / pause), 1);
+    struct stat buf;
+    for (int i=0; ; i++)
+    {
+        if ((i == tries) && (mFD < 0))
+            throw Exception("%s: %s does not exist", mObjectName, mName);
+        if (i == tries)
+            throw Exception("%s: %s is not a ring", mObjectName, mName);
+        if (i > 0)
+            usleep(pause);
+        if (mFD < 0)
+        {
+            mFD = shm_open(mName, O_RDWR, 0);
+            if ((mFD < 0) && (errno == ENOENT))
+                continue;
+            if (mFD < 0)
+            {
+                perror(mObjectName);
+                throw Exception("%s: shm_open() failed for %s",
+                                mObjectName, mName);
+            }
+        }
+
+        // Not truncated to size yet
+        if (fstat(mFD, &buf) < 0)
+            throw Exception("%s: fstat() failed for %s", mObjectName, mName);
+        if (buf.st_size < (off_t)dataOffset())
+            continue;
+        if (!mMap)
+            map(buf.st_size);
+
+        // Header not written yet
+        __sync_synchronize();
+        if (!memcmp(mHeader->magic, cSharedRingMagic, sizeof(mHeader->magic)))
+            break;
+    }
+
+    if (mHeader->version != cSharedRingVersion)
+        throw Exception("%s: %s has version %d, expected %d",
+                        mObjectName, mName, mHeader->version,
+                        cSharedRingVersion);
+    __sync_synchronize();
+    int frameSize = mHeader->frameSize;
+    mFrameBytes = ((frameSize == 0) ? 1 : frameSize) * sizeof(float);
+    if (dataOffset() + mHeader->capacity * mFrameBytes > (size_t)buf.st_size)
+        throw Exception("%s: %s is truncated", mObjectName, mName);
+}
+
+void Tracter::SharedRing::map(size_t iSize)
+{
+    mMap = mmap(0, iSize, PROT_READ | PROT_WRITE, MAP_SHARED, mFD, 0);
+    if (mMap == MAP_FAILED)
+    {
+        mMap = 0;
+        perror(mObjectName);
+        throw Exception("%s: mmap() failed for %s", mObjectName, mName);
+    }
+    mMapSize = iSize;
+    mHeader = (SharedRingHeader*)mMap;
+    mData = (float*)((char*)mMap + dataOffset());
+}
+
+/**
+ * Copy frames into the ring, waiting for the consumer to release
+ * space as necessary.  The head is published (and the consumer
+ * woken) after each contiguous copy.
+ */
+void Tracter::SharedRing::Write(const float* iData, SizeType iLength)
+{
+    assert(mOwner);
+    IndexType capacity = mHeader->capacity;
+    int frameFloats = mFrameBytes / sizeof(float);
+    while (iLength > 0)
+    {
+        IndexType head = mHeader->head;
+        IndexType space = capacity - (head - mHeader->tail);
+        if (space <= 0)
+        {
+            wait(&mHeader->tail, head - capacity + 1, &mHeader->detached,
+                 &mHeader->tailSeq, &mHeader->tailWaiters);
+            if (mHeader->detached)
+                throw Exception("%s: consumer detached from %s",
+                                mObjectName, mName);
+            continue;
+        }
+
+        SizeType offset = head % capacity;
+        SizeType len = std::min(
+            std::min((IndexType)iLength, space), capacity - offset
+        );
+        memcpy(mData + offset * frameFloats, iData, len * mFrameBytes);
+        __sync_synchronize();
+        mHeader->head = head + len;
+        wake(&mHeader->headSeq, &mHeader->headWaiters);
+        iData += len * frameFloats;
+        iLength -= len;
+    }
+}
+
+/**
+ * Mark the end of the stream; consumers waiting beyond it return.
+ */
+void Tracter::SharedRing::EndOfData()
+{
+    assert(mOwner);
+    __sync_synchronize();
+    mHeader->endOfData = 1;
+    wake(&mHeader->headSeq, &mHeader->headWaiters);
+}
+
+/**
+ * Wait until frame iIndex-1 has been written or there is no more
+ * data.  Returns the head, which may be beyond iIndex.
+ */
+Tracter::IndexType Tracter::SharedRing::WaitHead(IndexType iIndex)
+{
+    wait(&mHeader->head, iIndex, &mHeader->endOfData,
+         &mHeader->headSeq, &mHeader->headWaiters);
+    __sync_synchronize();
+    return mHeader->head;
+}
+
+/**
+ * Release frames before iIndex back to the producer.
+ */
+void Tracter::SharedRing::Release(IndexType iIndex)
+{
+    if (iIndex <= mHeader->tail)
+        return;
+    __sync_synchronize();
+    mHeader->tail = iIndex;
+    wake(&mHeader->tailSeq, &mHeader->tailWaiters);
+}
+
+/**
+ * Wait until *iIndex reaches iValue or *iFlag is set.  The waiter
+ * count is raised before the sequence word is sampled, so a wake()
+ * cannot be missed between the check and the sleep.
+ */
+void Tracter::SharedRing::wait(
+    volatile IndexType* iIndex, IndexType iValue,
+    volatile int* iFlag, volatile int* iSeq, volatile int* iWaiters
+)
+{
+    for (int i=0; i<mSpin; i++)
+        if ((*iIndex >= iValue) || *iFlag)
+            return;
+
+    while ((*iIndex < iValue) && !*iFlag)
+    {
+        __sync_fetch_and_add(iWaiters, 1);
+#ifdef HAVE_LINUX
+        int seq = *iSeq;
+#endif
+        if ((*iIndex < iValue) && !*iFlag)
+        {
+#ifdef HAVE_LINUX
+            // The timeout is only a safety net
+            struct timespec timeout = {0, 10000000};
+            syscall(SYS_futex, iSeq, FUTEX_WAIT, seq, &timeout, 0, 0);
+#else
+            usleep(100);
+#endif
+        }
+        __sync_fetch_and_sub(iWaiters, 1);
+    }
+}
+
+void Tracter::SharedRing::wake(volatile int* iSeq, volatile int* iWaiters)
+{
+    __sync_fetch_and_add(iSeq, 1);
+#ifdef HAVE_LINUX
+    if (*iWaiters)
+        syscall(SYS_futex, iSeq, FUTEX_WAKE, 1, 0, 0, 0);
+#endif
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#ifndef SHAREDRING_H
+#define SHAREDRING_H
+
+#include "Component.h"
+
+namespace Tracter
+{
+    /**
+     * Header at the start of a shared memory ring.  The producer and
+     * consumer indices live on separate cache lines; the sequence
+     * words are what the futex calls wait on.
+     */
+    struct SharedRingHeader
+    {
+        char magic[8];
+        int version;
+        int frameSize;              ///< As Frame().size of the producer
+        float frameRate;
+        int pad;
+        TimeType time;              ///< Time of frame 0 in ns
+        IndexType capacity;         ///< Ring size in frames
+        char pad0[24];
+
+        volatile IndexType head;    ///< Next frame to be written
+        volatile int headSeq;
+        volatile int headWaiters;
+        volatile int endOfData;
+        char pad1[44];
+
+        volatile IndexType tail;    ///< Frames before this are released
+        volatile int tailSeq;
+        volatile int tailWaiters;
+        volatile int detached;      ///< Set when the consumer goes away
+        char pad2[44];
+    };
+
+    /**
+     * Single producer, single consumer ring of frames in POSIX shared
+     * memory.
+     *
+     * The producer only ever writes head and the consumer only ever
+     * writes tail, so no locks are needed.  A waiting side spins
+     * briefly, then sleeps on a futex (Linux) or polls.  The name is
+     * removed when the producer goes away; a consumer that has
+     * attached by then keeps its mapping.
+     */
+    class SharedRing
+    {
+    public:
+        SharedRing(const char* iObjectName);
+        ~SharedRing();
+
+        void Create(
+            const char* iName, int iFrameSize, float iFrameRate,
+            TimeType iTime, IndexType iCapacity
+        );
+        void Attach(const char* iName, float iTimeout = 1.0f);
+
+        /** Number of spins before sleeping when waiting */
+        void Spin(int iSpin) { mSpin = iSpin; }
+
+        const SharedRingHeader& Header() const { return *mHeader; }
+        float* Data() { return mData; }
+        int FrameBytes() const { return mFrameBytes; }
+
+        void Write(const float* iData, SizeType iLength);
+        void EndOfData();
+        IndexType WaitHead(IndexType iIndex);
+        void Release(IndexType iIndex);
+
+    private:
+        const char* mObjectName;
+        char* mName;
+        bool mOwner;
+        int mFD;
+        void* mMap;
+        size_t mMapSize;
+        SharedRingHeader* mHeader;
+        float* mData;
+        int mFrameBytes;
+        int mSpin;
+
+        void map(size_t iSize);
+        void wait(
+            volatile IndexType* iIndex, IndexType iValue,
+            volatile int* iFlag, volatile int* iSeq, volatile int* iWaiters
+        );
+        void wake(volatile int* iSeq, volatile int* iWaiters);
+    };
+}
+
+#endif /* SHAREDRING_H */
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include "ShortTimeSpectrum.h"
+
+Tracter::ShortTimeSpectrum::ShortTimeSpectrum(
+    Component<float>* iInput,
+    const char* iObjectName
+)
+{
+    mInput = iInput;
+
+    // Default to the settings of the Frame and Periodogram replaced
+    mObjectName = "Frame";
+    int size = GetEnv("Size", 256);
+    int period = GetEnv("Period", 80);
+    mObjectName = "Periodogram";
+    int window = GetEnv("Window", 1);
+
+    mObjectName = iObjectName;
+    mSize = GetEnv("Size", size);
+    mFrame.period = GetEnv("Period", period);
+    mComplex = GetEnv("Complex", 0);
+    assert(mSize > 0);
+    assert(mFrame.period > 0);
+
+    // Framers look ahead, not back
+    Connect(mInput, mSize, mSize-1);
+    mFrame.size = mComplex ? (mSize/2+1)*2 : mSize/2+1;
+
+    mRealData = 0;
+    mComplexData = 0;
+    mFourier.Init(mSize, &mRealData, &mComplexData);
+
+    if (GetEnv("Window", window))
+        mWindow = new Window("Periodogram", mSize);
+    else
+        mWindow = 0;
+}
+
+Tracter::ShortTimeSpectrum::~ShortTimeSpectrum() throw ()
+{
+    delete mWindow;
+    mWindow = 0;
+}
+
+bool Tracter::ShortTimeSpectrum::UnaryFetch(IndexType iIndex, float* oData)
+{
+    assert(iIndex >= 0);
+    CacheArea inputArea;
+
+    // Read the input frame
+    IndexType readIndex = iIndex * mFrame.period;
+    int got = mInput->Read(inputArea, readIndex, mSize);
+    if (got < mSize)
+        return false;
+
+    // Copy the frame straight from the sample cache via the window
+    float* ip = mInput->GetPointer();
+    int len0 = inputArea.len[0];
+    if (mWindow)
+    {
+        mWindow->Apply(ip + inputArea.offset, mRealData, 0, len0);
+        mWindow->Apply(ip, mRealData + len0, len0, inputArea.len[1]);
+    }
+    else
+    {
+        for (int i=0; i<len0; i++)
+            mRealData[i] = ip[inputArea.offset+i];
+        for (int i=0; i<inputArea.len[1]; i++)
+            mRealData[len0+i] = ip[i];
+    }
+
+    // Do the DFT
+    mFourier.Transform();
+
+    // Compute the output
+    int nBins = mSize/2+1;
+    if (mComplex)
+        for (int i=0; i<nBins; i++)
+        {
+            oData[i*2]   = mComplexData[i].real();
+            oData[i*2+1] = mComplexData[i].imag();
+        }
+    else
+        for (int i=0; i<nBins; i++)
+            oData[i] =
+                mComplexData[i].real() * mComplexData[i].real() +
+                mComplexData[i].imag() * mComplexData[i].imag();
+
+    return true;
+}
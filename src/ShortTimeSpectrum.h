@@ -0,0 +1,51 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#ifndef SHORTTIMESPECTRUM_H
+#define SHORTTIMESPECTRUM_H
+
+#include "Window.h"
+#include "Fourier.h"
+#include "CachedComponent.h"
+
+namespace Tracter
+{
+    /**
+     * Short time spectrum.  Equivalent to a Frame followed by a
+     * Periodogram, but reads the sample cache directly and applies
+     * the window while loading the Fourier transform input, so each
+     * frame is copied once rather than three times.
+     *
+     * The output is the power spectrum by default.  If Complex is
+     * set, it is instead the complex spectrum as interleaved real and
+     * imaginary parts, i.e., Size/2+1 pairs.
+     *
+     * Size and Period default to Frame_Size and Frame_Period, and
+     * Window to Periodogram_Window, so it can stand in for an
+     * existing configuration.  The window shape is Periodogram_Shape.
+     */
+    class ShortTimeSpectrum : public CachedComponent<float>
+    {
+    public:
+        ShortTimeSpectrum(Component<float>* iInput,
+                          const char* iObjectName = "ShortTimeSpectrum");
+        virtual ~ShortTimeSpectrum() throw();
+
+    protected:
+        bool UnaryFetch(IndexType iIndex, float* oData);
+
+    private:
+        Component<float>* mInput;
+        int mSize;
+        bool mComplex;
+        float* mRealData;
+        complex* mComplexData;
+        Window* mWindow;
+        Fourier mFourier;
+    };
+}
+
+#endif /* SHORTTIMESPECTRUM_H */
@@ -14,8 +14,13 @@
 # include <unistd.h>
 # include <sys/types.h>
 # include <sys/socket.h>
+# include <sys/uio.h>
+# include <netinet/in.h>
+# include <netinet/tcp.h>
 # include <arpa/inet.h>
+# include <errno.h>
 #endif
+#include <algorithm>
 
 #include "SocketSink.h"
 
@@ -29,7 +34,16 @@ Tracter::SocketSink::SocketSink(
 {
     mObjectName = iObjectName;
     mInput = iInput;
-    Connect(mInput);
+
+    // Batch size is bounded both by number and by time
+    float flushTime = GetEnv("FlushTime", 0.01f);
+    float frameRate = mInput->FrameRate() / mInput->Frame().period;
+    SizeType flushFrames = (SizeType)(flushTime * frameRate);
+    mBatch = std::max(
+        std::min((SizeType)GetEnv("BatchSize", 1024), flushFrames),
+        (SizeType)1
+    );
+    Connect(mInput, mBatch);
 
     mFrame.size = mInput->Frame().size;
     Initialise();
@@ -92,6 +106,19 @@ Tracter::SocketSink::SocketSink(
                         mObjectName, mPort);
     }
     Verbose(1, "got connection from %s\n", inet_ntoa(client.sin_addr));
+
+    // We do our own batching, so Nagle would just add latency
+    if (GetEnv("NoDelay", 1))
+    {
+        if (setsockopt(mFD, IPPROTO_TCP, TCP_NODELAY,
+                       (char*)&yes, sizeof(yes)) == -1)
+        {
+            perror(mObjectName);
+            throw Exception("%s: setsockopt(TCP_NODELAY) failed\n",
+                            mObjectName);
+        }
+    }
+    Verbose(1, "sending batches of %ld frames\n", mBatch);
 #ifdef _WIN32
     closesocket(sockFD);
 #else
@@ -128,31 +155,84 @@ Tracter::SocketSink::~SocketSink() throw()
 void Tracter::SocketSink::Pull()
 {
     CacheArea ca;
-    int index = 0;
-    int total = 0;
-    int arraySize = mFrame.size == 0 ? 1 : mFrame.size;
-    while(mInput->Read(ca, index++))
+    IndexType index = 0;
+    SizeType got;
+    while ((got = mInput->Read(ca, index, mBatch)) > 0)
     {
-        float* data = mInput->GetPointer(ca.offset);
-        ssize_t nSend = arraySize*sizeof(float);
+        transmit(
+            mInput->GetPointer(ca.offset), ca.len[0],
+            mInput->GetPointer(0), ca.len[1]
+        );
+        Verbose(2, "Sent %ld frames at %lld\n", got, index);
+        index += got;
+        if (got < mBatch)
+            break;
+    }
 #ifdef _WIN32
-        ssize_t nSent = send(mFD, (char*)data, nSend, 0);
+    closesocket(mFD);
 #else
-        ssize_t nSent = send(mFD, data, nSend, 0);
+    close(mFD);
 #endif
-        Verbose(2, "Send %d  sent %d  total %d\n",
-                (int)nSend, (int)nSent, total++);
+    mFD = 0;
+}
+
+/**
+ * Send the two segments of a cache area, looping over partial
+ * writes.
+ */
+void Tracter::SocketSink::transmit(
+    const float* iData0, SizeType iLen0,
+    const float* iData1, SizeType iLen1
+)
+{
+    int arraySize = mFrame.size == 0 ? 1 : mFrame.size;
+    size_t nSend0 = iLen0 * arraySize * sizeof(float);
+    size_t nSend1 = iLen1 * arraySize * sizeof(float);
+#ifdef _WIN32
+    const char* data[2] = { (const char*)iData0, (const char*)iData1 };
+    size_t nSend[2] = { nSend0, nSend1 };
+    for (int i=0; i<2; i++)
+        while (nSend[i] > 0)
+        {
+            int nSent = send(mFD, data[i], nSend[i], 0);
+            if (nSent == -1)
+                throw Exception("%s: send() failed for port %hu\n",
+                                mObjectName, mPort);
+            data[i] += nSent;
+            nSend[i] -= nSent;
+        }
+#else
+    struct iovec iov[2];
+    iov[0].iov_base = (void*)iData0;
+    iov[0].iov_len = nSend0;
+    iov[1].iov_base = (void*)iData1;
+    iov[1].iov_len = nSend1;
+    struct iovec* v = iov;
+    int nv = (nSend1 > 0) ? 2 : 1;
+    while (nv > 0)
+    {
+        ssize_t nSent = writev(mFD, v, nv);
         if (nSent == -1)
         {
+            if (errno == EINTR)
+                continue;
             perror(mObjectName);
-            throw Exception("%s: send() failed for port %hu\n",
+            throw Exception("%s: writev() failed for port %hu\n",
                             mObjectName, mPort);
         }
+
+        // Step over whatever was written
+        while ((nv > 0) && ((size_t)nSent >= v->iov_len))
+        {
+            nSent -= v->iov_len;
+            v++;
+            nv--;
+        }
+        if (nv > 0)
+        {
+            v->iov_base = (char*)v->iov_base + nSent;
+            v->iov_len -= nSent;
+        }
     }
-#ifdef _WIN32
-    closesocket(mFD);
-#else
-    close(mFD);
 #endif
-    mFD = 0;
 }
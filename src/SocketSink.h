@@ -15,6 +15,11 @@ namespace Tracter
 {
     /**
      * Sinks to a socket.
+     *
+     * Frames are sent in batches, each batch being one Read() from
+     * the input and one writev() straight from the input's cache.
+     * FlushTime bounds the duration of a batch, and hence the extra
+     * latency; BatchSize bounds the number of frames.
      */
     class SocketSink : public Sink
     {
@@ -30,6 +35,12 @@ namespace Tracter
         int mFD;
         unsigned short mPort;
         bool mHeader;
+        SizeType mBatch;
+
+        void transmit(
+            const float* iData0, SizeType iLen0,
+            const float* iData1, SizeType iLen1
+        );
     };
 }
 
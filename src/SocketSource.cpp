@@ -18,7 +18,11 @@
 # include <unistd.h>
 # include <sys/types.h>
 # include <sys/socket.h>
+# include <sys/uio.h>
+# include <netinet/in.h>
+# include <netinet/tcp.h>
 # include <arpa/inet.h>
+# include <errno.h>
 #endif
 
 #include "SocketSource.h"
@@ -29,6 +33,7 @@ Tracter::socketSource::socketSource(const char* iObjectName)
     mObjectName = iObjectName;
     mPort = GetEnv("Port", 30000);
     mBufferSize = GetEnv("BufferSize", 0);
+    mNoDelay = GetEnv("NoDelay", 1);
     mFD = 0;
 }
 
@@ -116,6 +121,15 @@ void Tracter::socketSource::Open(const char* iHostName)
         Verbose(1, "resize: requested %d granted %d\n", mBufferSize, optVal);
     }
 
+    // Replies to anything we send are latency critical
+    if (mNoDelay)
+    {
+        optVal = 1;
+        if (setsockopt(mFD, IPPROTO_TCP, TCP_NODELAY,
+                       (char*)&optVal, sizeof(optVal)))
+            throw Exception("setsockopt failed");
+    }
+
     // Connect using the host address, port and file descriptor
     struct sockaddr_in server;
     server.sin_family = AF_INET;
@@ -163,6 +177,49 @@ int Tracter::socketSource::Receive(int iNBytes, char* iBuffer)
     return (int)nGot;
 }
 
+/**
+ * Receive data from socket into two buffers.  Unlike the single
+ * buffer version, this is a single readv() call; it blocks until some
+ * data is available, then returns whatever has arrived.  The second
+ * buffer is only written once the first is full.
+ *
+ * @returns the number of bytes actually received; 0 implies end of
+ * stream.
+ */
+int Tracter::socketSource::Receive(
+    int iNBytes0, char* iBuffer0, int iNBytes1, char* iBuffer1
+)
+{
+    assert(iNBytes0 >= 0);
+    assert(iNBytes1 >= 0);
+    assert(iBuffer0);
+#ifdef _WIN32
+    // No readv(); just fill the first buffer that has space
+    ssize_t n = (iNBytes0 > 0)
+        ? recv(mFD, iBuffer0, iNBytes0, 0)
+        : recv(mFD, iBuffer1, iNBytes1, 0);
+#else
+    struct iovec iov[2];
+    iov[0].iov_base = iBuffer0;
+    iov[0].iov_len = iNBytes0;
+    iov[1].iov_base = iBuffer1;
+    iov[1].iov_len = iNBytes1;
+    ssize_t n;
+    do
+        n = readv(mFD, iov, (iNBytes1 > 0) ? 2 : 1);
+    while ((n == -1) && (errno == EINTR));
+#endif
+    if (n == -1)
+    {
+        perror(mObjectName);
+        throw Exception("%s: readv failed for %d bytes",
+                        mObjectName, iNBytes0 + iNBytes1);
+    }
+    if (n == 0)
+        Verbose(1, "Read 0\n");
+    return (int)n;
+}
+
 /**
  * Send data to a socket
  */
@@ -8,6 +8,8 @@
 #ifndef SOCKETSOURCE_H
 #define SOCKETSOURCE_H
 
+#include <algorithm>
+
 #include "CachedComponent.h"
 #include "Source.h"
 
@@ -23,11 +25,15 @@ namespace Tracter
         virtual ~socketSource() throw ();
         virtual void Open(const char* iHostName);
         int Receive(int iNBytes, char* iBuffer);
+        int Receive(
+            int iNBytes0, char* iBuffer0, int iNBytes1, char* iBuffer1
+        );
         void Send(int iNBytes, char* iBuffer);
 
     private:
         int mFD;
         int mBufferSize;
+        bool mNoDelay;
         unsigned short mPort;
     };
 
@@ -53,6 +59,16 @@ namespace Tracter
                 Source< CachedComponent<T> >::GetEnv("FramePeriod", 1);
             Source< CachedComponent<T> >::mFrameRate =
                 Source< CachedComponent<T> >::GetEnv("FrameRate", 48000.0f);
+
+            // The cache is filled ahead of requests with whatever has
+            // arrived, up to ChunkSize bytes at a time
+            int frameBytes = Source< CachedComponent<T> >::mFrame.size;
+            frameBytes = ((frameBytes == 0) ? 1 : frameBytes) * sizeof(T);
+            int chunkSize =
+                Source< CachedComponent<T> >::GetEnv("ChunkSize", 65536);
+            mChunk = std::max(chunkSize / frameBytes, 1);
+            mPartial = 0;
+            Source< CachedComponent<T> >::mAsync = true;
         }
         virtual ~SocketSource() throw () {}
         virtual void Open(
@@ -62,42 +78,71 @@ namespace Tracter
         )
         {
             mSocket.Open(iHostName);
+            mPartial = 0;
         }
 
     protected:
         /**
-         * A simple fetch call.  Implemented as two calls to
-         * Receive().
+         * Make room for the read-ahead chunk on top of what the
+         * graph asked for.
          */
-        virtual SizeType Fetch(IndexType iIndex, CacheArea& iOutputArea)
+        virtual void Resize(SizeType iSize)
         {
-            int getSize = Source< CachedComponent<T> >::mFrame.size;
-            getSize = ((getSize == 0) ? 1 : getSize) * sizeof(T);
+            CachedComponent<T>::Resize(iSize + mChunk);
+        }
 
-            // First chunk of circular array
-            char* cache = (char*)Source< CachedComponent<T> >::GetPointer(
-                iOutputArea.offset
-            );
-            SizeType nGet = getSize * iOutputArea.len[0];
-            SizeType nGot0 = mSocket.Receive(nGet, cache);
-            if (nGot0 < nGet)
-                return nGot0 / getSize;
+        /**
+         * Fetch by receiving directly into the cache.  Each
+         * Receive() is a single readv() over the (up to) two
+         * contiguous segments between the head of the cache and
+         * ChunkSize beyond the request, so it returns as much as has
+         * arrived.  The extra data is kept as cache, with the head
+         * managed here rather than by Read().
+         */
+        virtual SizeType Fetch(IndexType iIndex, CacheArea& iOutputArea)
+        {
+            CachePointer& head = this->mCluster[0].head;
+            CachePointer& tail = this->mCluster[0].tail;
+            if (iIndex != head.index)
+                throw Exception("%s: non-sequential read at %lld, head %lld",
+                                this->mObjectName, iIndex, head.index);
 
-            if (iOutputArea.len[1])
+            int frameBytes = Source< CachedComponent<T> >::mFrame.size;
+            frameBytes = ((frameBytes == 0) ? 1 : frameBytes) * sizeof(T);
+            char* cache = (char*)Source< CachedComponent<T> >::GetPointer();
+            SizeType cacheBytes = this->mSize * frameBytes;
+            IndexType end = iIndex + iOutputArea.Length();
+            IndexType limit = end + mChunk;
+            assert(limit - head.index <= this->mSize);
+            while (head.index < end)
             {
-                // Second chunk of circular array
-                cache = (char*)Source< CachedComponent<T> >::GetPointer();
-                nGet = getSize * iOutputArea.len[1];
-                int nGot1 = mSocket.Receive(nGet, cache);
-                if (nGot1 < nGet)
-                    return (nGot0 + nGot1) / getSize;
+                SizeType start = head.offset * frameBytes + mPartial;
+                SizeType nBytes = (limit - head.index) * frameBytes - mPartial;
+                SizeType nBytes0 = std::min(nBytes, cacheBytes - start);
+                int nGot = mSocket.Receive(
+                    nBytes0, cache + start, nBytes - nBytes0, cache
+                );
+                if (nGot == 0)
+                    break;
+
+                // Only whole frames move the head
+                nGot += mPartial;
+                mPartial = nGot % frameBytes;
+                this->MovePointer(head, nGot / frameBytes);
+                if (head.index - tail.index > this->mSize)
+                    this->MovePointer(
+                        tail, head.index - tail.index - this->mSize
+                    );
             }
 
-            // If we get here, all was well
-            return iOutputArea.Length();
+            return std::min(head.index, end) - iIndex;
         }
 
         socketSource mSocket;
+
+    private:
+        SizeType mChunk;
+        int mPartial;
     };
 }
 
@@ -16,46 +16,7 @@
 #include <arpa/inet.h>
 #include <fcntl.h>
 #include <errno.h>
-
-Tracter::Thread::Thread()
-{
-    mThreadId = 0;
-}
-
-void Tracter::Thread::Start()
-{
-    // Create a new thread with default attributes
-    if (pthread_create(&mThreadId, 0, staticStart, this))
-        throw Exception("Unable to create thread");
-}
-
-void* Tracter::Thread::staticStart(void* iThread)
-{
-    // Incoming iThread is 'this' pointer
-    ((Thread*)iThread)->start();
-    return 0;
-}
-
-Tracter::Mutex::Mutex()
-{
-    pthread_mutex_init(&mMutex, 0);
-}
-
-Tracter::Mutex::~Mutex() throw ()
-{
-    pthread_mutex_destroy(&mMutex);
-}
-
-void Tracter::Mutex::Lock()
-{
-    pthread_mutex_lock(&mMutex);
-}
-
-void Tracter::Mutex::Unlock()
-{
-    pthread_mutex_unlock(&mMutex);
-}
-
+#include <algorithm>
 
 /**
  * Constructor.  Obtains a socket descriptor to use with subsequent
@@ -82,9 +43,12 @@ Tracter::Socket::~Socket() throw ()
 
 /**
  * Binds a socket to a local address and instructs it to listen for
+ * connections.  iBacklog is the length of the queue of pending
  * connections.
  */
-void Tracter::Socket::Listen(unsigned short iPort, bool iNonBlock)
+void Tracter::Socket::Listen(
+    unsigned short iPort, bool iNonBlock, int iBacklog
+)
 {
     // Set (non-)blocking behaviour
     mNonBlock = iNonBlock;
@@ -116,7 +80,7 @@ void Tracter::Socket::Listen(unsigned short iPort, bool iNonBlock)
     }
 
     // listen
-    if (listen(mFD, 1) == -1)
+    if (listen(mFD, iBacklog) == -1)
     {
         perror("Socket");
         throw Exception("Socket: listen() failed for port %hu\n", iPort);
@@ -180,6 +144,16 @@ void Tracter::Socket::start()
     }
 }
 
+namespace Tracter
+{
+    const StringEnum cTeeOverflow[] = {
+        {"Block",      TEE_BLOCK},
+        {"DropOldest", TEE_DROP_OLDEST},
+        {"Disconnect", TEE_DISCONNECT},
+        {0,            -1}
+    };
+}
+
 /**
  * Constructor.
  */
@@ -191,10 +165,32 @@ Tracter::SocketTee::SocketTee(Component<float>* iInput, const char* iObjectName)
     mInput = iInput;
     Connect(mInput, 1);
 
+    // The ring buffer
+    mOverflow = (TeeOverflow)GetEnv(cTeeOverflow, TEE_DROP_OLDEST);
+    mRingSize = std::max(SecondsToFrames(GetEnv("BufferTime", 1.0f)), 1L);
+    int arraySize = mFrame.size == 0 ? 1 : mFrame.size;
+    mRing.resize(mRingSize * arraySize);
+    mChunk = std::max(mRingSize / 4, 1L);
+    mSend.resize(mChunk * arraySize);
+    mHead = 0;
+    mTail = 0;
+    mFlight = 0;
+    mDropped = 0;
+    mSent = 0;
+    mStop = false;
+    mDead = 0;
+    float timeout = GetEnv("SendTimeout", 1.0f);
+    mSendTimeout.tv_sec = (time_t)timeout;
+    mSendTimeout.tv_usec =
+        (suseconds_t)((timeout - mSendTimeout.tv_sec) * 1e6f);
+
     unsigned short port = GetEnv("Port", 30000);
     mFD = 0;
     mSocket.Listen(port, false);
     mAcceptMutex = mSocket.AcceptThread(1, &mFD);
+
+    // The I/O thread
+    Start();
 }
 
 bool Tracter::SocketTee::UnaryFetch(IndexType iIndex, float* oData)
@@ -210,42 +206,217 @@ bool Tracter::SocketTee::UnaryFetch(IndexType iIndex, float* oData)
     for (int i=0; i<mFrame.size; i++)
         oData[i] = input[i];
 
-    // If there is a connection, output to the socket too
-    mAcceptMutex->Lock();
-    if (mFD)
+    // Nothing to queue unless someone is listening
+    int fd = connection();
+    if (!fd)
+        return true;
+
+    mMutex.Lock();
+    if (mHead - mTail + mFlight >= mRingSize)
+        switch (mOverflow)
+        {
+        case TEE_BLOCK:
+            while ((mHead - mTail + mFlight >= mRingSize) && connection())
+                mSpace.Wait(mMutex);
+            break;
+        case TEE_DROP_OLDEST:
+            // Frames being sent can't be dropped; if that's all there
+            // is, this frame goes instead
+            mDropped++;
+            if (mHead == mTail)
+            {
+                mMutex.Unlock();
+                return true;
+            }
+            mTail++;
+            break;
+        case TEE_DISCONNECT:
+            Verbose(1, "overflow: disconnecting\n");
+            mDropped += mHead - mTail;
+            mTail = mHead;
+            disconnect(fd);
+            break;
+        }
+
+    if (connection())
     {
+        int arraySize = mFrame.size == 0 ? 1 : mFrame.size;
+        float* slot = &mRing[(mHead % mRingSize) * arraySize];
+        for (int i=0; i<arraySize; i++)
+            slot[i] = input[i];
+        mHead++;
+        mData.Signal();
+    }
+    mMutex.Unlock();
+
+    return true;
+}
+
+/**
+ * The I/O thread.  Copies up to mChunk queued frames out of the ring,
+ * then sends them without holding the lock.  They count against the
+ * ring until they're sent.
+ */
+void Tracter::SocketTee::start()
+{
+    int arraySize = mFrame.size == 0 ? 1 : mFrame.size;
+    int timed = 0;
+    for (;;)
+    {
+        mMutex.Lock();
+        if (mDead)
+        {
+            close(mDead);
+            if (timed == mDead)
+                timed = 0;
+            mDead = 0;
+        }
+        while (!mStop && (mHead == mTail))
+            mData.Wait(mMutex);
+        if (mHead == mTail)
+        {
+            // Stopping, and there's nothing left to send
+            mMutex.Unlock();
+            break;
+        }
+        SizeType n = std::min(mHead - mTail, (IndexType)mChunk);
+        for (SizeType i=0; i<n; i++)
+        {
+            float* slot = &mRing[((mTail + i) % mRingSize) * arraySize];
+            for (int j=0; j<arraySize; j++)
+                mSend[i * arraySize + j] = slot[j];
+        }
+        mTail += n;
+        mFlight = n;
+        mMutex.Unlock();
+
+        /*
+         * A stalled consumer would otherwise block send() forever,
+         * and with it the destructor.  With a timeout, a send that
+         * makes no progress is retried until we're stopping, then
+         * the connection is dropped.
+         */
+        int fd = connection();
+        if (fd && (fd != timed))
+        {
+            setsockopt(
+                fd, SOL_SOCKET, SO_SNDTIMEO,
+                &mSendTimeout, sizeof(mSendTimeout)
+            );
+            timed = fd;
+        }
+
         /*
          * If the other end breaks the connection, we'd normally get a
          * SIG_PIPE signal (= bomb out).  This one returns EPIPE.
          */
+        char* data = (char*)&mSend[0];
+        size_t nSend = fd ? n * arraySize * sizeof(float) : 0;
+        while (nSend > 0)
+        {
 #ifdef HAVE_LINUX
-          ssize_t s = send(mFD, input, sizeof(float) * mFrame.size, MSG_NOSIGNAL);
+            ssize_t s = send(fd, data, nSend, MSG_NOSIGNAL);
 #endif
 
 #ifdef HAVE_DARWIN
-          ssize_t s = send(mFD, input, sizeof(float) * mFrame.size, SO_NOSIGPIPE);
+            ssize_t s = send(fd, data, nSend, SO_NOSIGPIPE);
 #endif
 
-        if (s == -1)
-            switch (errno)
+            if (s == -1)
             {
-            case EPIPE:
-                // Broken connection
-                close(mFD);
-                mFD = 0;
+                if (errno == EINTR)
+                    continue;
+                if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+                {
+                    mMutex.Lock();
+                    bool stop = mStop;
+                    mMutex.Unlock();
+                    if (!stop)
+                        continue;
+                    Verbose(1, "send timed out: disconnecting\n");
+                }
+                else if ((errno != EPIPE) && (errno != ECONNRESET))
+                    perror(mObjectName);
+                mMutex.Lock();
+                disconnect(fd);
+                mMutex.Unlock();
                 break;
-            default:
-                perror(mObjectName);
-                throw Exception("%s: Failed to write()", mObjectName);
             }
+            data += s;
+            nSend -= s;
+        }
+
+        mMutex.Lock();
+        if (fd && (nSend == 0))
+            mSent += n;
+        else
+            mDropped += n;
+        mFlight = 0;
+        mSpace.Signal();
+        mMutex.Unlock();
     }
+}
+
+/** Number of frames discarded due to overflow */
+Tracter::IndexType Tracter::SocketTee::Dropped() const
+{
+    mMutex.Lock();
+    IndexType dropped = mDropped;
+    mMutex.Unlock();
+    return dropped;
+}
+
+/** Number of frames written to the socket */
+Tracter::IndexType Tracter::SocketTee::Sent() const
+{
+    mMutex.Lock();
+    IndexType sent = mSent;
+    mMutex.Unlock();
+    return sent;
+}
+
+/**
+ * Get the current connection, or 0 if there isn't one.
+ */
+int Tracter::SocketTee::connection()
+{
+    mAcceptMutex->Lock();
+    int fd = mFD;
     mAcceptMutex->Unlock();
+    return fd;
+}
 
-    return true;
+/**
+ * Drop the given connection.  The socket is shut down rather than
+ * closed here, so an I/O thread blocked in send() on it returns; the
+ * I/O thread closes it later.  Call with mMutex locked.
+ */
+void Tracter::SocketTee::disconnect(int iFD)
+{
+    mAcceptMutex->Lock();
+    if (mFD == iFD)
+    {
+        shutdown(mFD, SHUT_RDWR);
+        mDead = mFD;
+        mFD = 0;
+    }
+    mAcceptMutex->Unlock();
+    mSpace.Broadcast();
 }
 
 Tracter::SocketTee::~SocketTee() throw()
 {
+    // Let the I/O thread flush the ring, then wait for it.  A stalled
+    // consumer holds this up by at most SendTimeout.
+    mMutex.Lock();
+    mStop = true;
+    mData.Signal();
+    mMutex.Unlock();
+    Join();
+
+    Verbose(1, "sent %lld frames, dropped %lld\n", mSent, mDropped);
+    if (mDead)
+        close(mDead);
     if (mFD)
         close(mFD);
     mFD = 0;
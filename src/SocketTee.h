@@ -8,47 +8,13 @@
 #ifndef SOCKETTEE_H
 #define SOCKETTEE_H
 
-#include "CachedComponent.h"
+#include <sys/time.h>
 
-#include <pthread.h>
+#include "CachedComponent.h"
+#include "Thread.h"
 
 namespace Tracter
 {
-    /**
-     * Thread class.  Allows creation of threads where the start
-     * routine is a method.  In linux, this is just a very thin
-     * wrapper around pthreads.
-     */
-    class Thread
-    {
-    public:
-        Thread();
-        virtual ~Thread() throw () {}
-        void Start();
-        virtual void start() = 0;
-
-    private:
-        static void* staticStart(void* iThread);
-        pthread_t mThreadId;
-    };
-
-    /**
-     * Mutex class.  In linux this is just a very thin wrapper around
-     * the pthreads mutex.
-     */
-    class Mutex
-    {
-    public:
-        Mutex();
-        virtual ~Mutex() throw ();
-        void Lock();
-        void Unlock();
-
-    private:
-        pthread_mutex_t mMutex;
-    };
-
-
     /**
      * Socket class.  Maintains a socket.
      */
@@ -57,8 +23,11 @@ namespace Tracter
     public:
         Socket();
         virtual ~Socket() throw ();
-        void Listen(unsigned short iPort, bool iNonBlock = false);
+        void Listen(
+            unsigned short iPort, bool iNonBlock = false, int iBacklog = 1
+        );
         int Accept();
+        int Descriptor() const { return mFD; }
         Mutex* AcceptThread(int iNFD, int* iFD);
 
     private:
@@ -68,17 +37,39 @@ namespace Tracter
         int mAcceptFDSize;
         int mNAcceptFD;
         int* mAcceptFD;
-        Mutex mMutex;
+        mutable Mutex mMutex;
 
         virtual void start();
     };
 
 
+    enum TeeOverflow
+    {
+        TEE_BLOCK,
+        TEE_DROP_OLDEST,
+        TEE_DISCONNECT
+    };
+
+    extern const StringEnum cTeeOverflow[];
+
     /**
      * Socket tee piece.  Passes input to output unchanged, but also
      * passes it into a socket connection.
+     *
+     * The graph thread never writes to the socket.  Frames go into a
+     * bounded ring buffer that is drained by a separate I/O thread.
+     * When the ring is full (a slow or stalled consumer), the
+     * Overflow policy decides what happens: Block waits for space,
+     * so back-pressures the graph like a plain socket would;
+     * DropOldest (the default) discards the oldest queued frames;
+     * Disconnect drops the connection and everything queued.
+     * The ring holds BufferTime of frames including those the I/O
+     * thread is part way through sending, which it takes a quarter of
+     * the ring at a time.  Sends time out after SendTimeout seconds
+     * without progress; the I/O thread retries, except when the tee
+     * is being destroyed, when the connection is dropped instead.
      */
-    class SocketTee : public CachedComponent<float>
+    class SocketTee : public CachedComponent<float>, public Thread
     {
     public:
         SocketTee(
@@ -86,6 +77,9 @@ namespace Tracter
         );
         virtual ~SocketTee() throw();
 
+        IndexType Dropped() const;
+        IndexType Sent() const;
+
     protected:
         bool UnaryFetch(IndexType iIndex, float* oData);
 
@@ -94,6 +88,27 @@ namespace Tracter
         int mFD;
         Socket mSocket;
         Mutex* mAcceptMutex;
+
+        TeeOverflow mOverflow;
+        std::vector<float> mRing;
+        SizeType mRingSize;
+        IndexType mHead;
+        IndexType mTail;
+        SizeType mChunk;
+        SizeType mFlight;
+        IndexType mDropped;
+        IndexType mSent;
+        bool mStop;
+        int mDead;
+        struct timeval mSendTimeout;
+        mutable Mutex mMutex;
+        Condition mData;
+        Condition mSpace;
+        std::vector<float> mSend;
+
+        int connection();
+        void disconnect(int iFD);
+        virtual void start();
     };
 }
 
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <cmath>
+
+#include "SpectralEnergy.h"
+
+Tracter::SpectralEnergy::SpectralEnergy(
+    Component<float>* iInput,
+    const char* iObjectName
+)
+{
+    mObjectName = iObjectName;
+    mInput = iInput;
+    Connect(iInput);
+
+    int bins = iInput->Frame().size;
+    if (bins < 2)
+        throw Exception("%s: input size %d is not a spectrum",
+                        mObjectName, bins);
+    mScale = 1.0f / (2 * (bins - 1));
+}
+
+bool Tracter::SpectralEnergy::UnaryFetch(IndexType iIndex, float* oData)
+{
+    assert(iIndex >= 0);
+
+    // Read the input frame
+    const float* p = mInput->UnaryRead(iIndex);
+    if (!p)
+        return false;
+
+    // Parseval; the middle bins stand for their negative frequencies too
+    int last = mInput->Frame().size - 1;
+    float sum = 0.0f;
+    for (int i=1; i<last; i++)
+        sum += p[i];
+    *oData = (p[0] + p[last] + 2.0f * sum) * mScale;
+
+    // Done
+    Verbose(4, "plot %ld %e\n", iIndex, 10.0*log10(*oData));
+    return true;
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#ifndef SPECTRALENERGY_H
+#define SPECTRALENERGY_H
+
+#include "CachedComponent.h"
+
+namespace Tracter
+{
+    /**
+     * Frame energy from a power spectrum.
+     *
+     * By Parseval's theorem, the energy of a frame is the sum of its
+     * power spectrum, with the bins other than DC and Nyquist counted
+     * twice, divided by the DFT size.  So a graph that already has a
+     * Periodogram can get energy without framing the signal again.
+     * The input is assumed to be the N/2+1 bins of an even sized DFT,
+     * and the result is the energy of whatever the DFT saw, i.e., the
+     * windowed frame.
+     */
+    class SpectralEnergy : public CachedComponent<float>
+    {
+    public:
+        SpectralEnergy(Component<float>* iInput,
+                       const char* iObjectName = "SpectralEnergy");
+
+    protected:
+        bool UnaryFetch(IndexType iIndex, float* oData);
+
+    private:
+        Component<float>* mInput;
+        float mScale;
+    };
+}
+
+#endif /* SPECTRALENERGY_H */
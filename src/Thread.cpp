@@ -0,0 +1,91 @@
+/*
+ * Copyright 2008 by IDIAP Research Institute
+ *                   http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include "Thread.h"
+#include "TracterObject.h"
+
+Tracter::Thread::Thread()
+{
+    mThreadId = 0;
+}
+
+void Tracter::Thread::Start()
+{
+    // Create a new thread with default attributes
+    if (pthread_create(&mThreadId, 0, staticStart, this))
+        throw Exception("Unable to create thread");
+}
+
+/**
+ * Wait for the thread to finish.  Does nothing if the thread was
+ * never started.
+ */
+void Tracter::Thread::Join()
+{
+    if (!mThreadId)
+        return;
+    if (pthread_join(mThreadId, 0))
+        throw Exception("Unable to join thread");
+    mThreadId = 0;
+}
+
+void* Tracter::Thread::staticStart(void* iThread)
+{
+    // Incoming iThread is 'this' pointer
+    ((Thread*)iThread)->start();
+    return 0;
+}
+
+Tracter::Mutex::Mutex()
+{
+    pthread_mutex_init(&mMutex, 0);
+}
+
+Tracter::Mutex::~Mutex() throw ()
+{
+    pthread_mutex_destroy(&mMutex);
+}
+
+void Tracter::Mutex::Lock()
+{
+    pthread_mutex_lock(&mMutex);
+}
+
+void Tracter::Mutex::Unlock()
+{
+    pthread_mutex_unlock(&mMutex);
+}
+
+Tracter::Condition::Condition()
+{
+    pthread_cond_init(&mCondition, 0);
+}
+
+Tracter::Condition::~Condition() throw ()
+{
+    pthread_cond_destroy(&mCondition);
+}
+
+/**
+ * Atomically unlock the mutex and wait for a signal.  The mutex is
+ * locked again on return.  As with pthreads, the wait can return
+ * spuriously, so the caller should test its predicate in a loop.
+ */
+void Tracter::Condition::Wait(Mutex& iMutex)
+{
+    pthread_cond_wait(&mCondition, &iMutex.mMutex);
+}
+
+void Tracter::Condition::Signal()
+{
+    pthread_cond_signal(&mCondition);
+}
+
+void Tracter::Condition::Broadcast()
+{
+    pthread_cond_broadcast(&mCondition);
+}
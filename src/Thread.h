@@ -0,0 +1,70 @@
+/*
+ * Copyright 2008 by IDIAP Research Institute
+ *                   http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#ifndef THREAD_H
+#define THREAD_H
+
+#include <pthread.h>
+
+namespace Tracter
+{
+    /**
+     * Thread class.  Allows creation of threads where the start
+     * routine is a method.  In linux, this is just a very thin
+     * wrapper around pthreads.
+     */
+    class Thread
+    {
+    public:
+        Thread();
+        virtual ~Thread() throw () {}
+        void Start();
+        void Join();
+        virtual void start() = 0;
+
+    private:
+        static void* staticStart(void* iThread);
+        pthread_t mThreadId;
+    };
+
+    /**
+     * Mutex class.  In linux this is just a very thin wrapper around
+     * the pthreads mutex.
+     */
+    class Mutex
+    {
+    public:
+        Mutex();
+        virtual ~Mutex() throw ();
+        void Lock();
+        void Unlock();
+
+    private:
+        friend class Condition;
+        pthread_mutex_t mMutex;
+    };
+
+    /**
+     * Condition variable.  A thin wrapper around the pthreads
+     * condition variable.  Wait() must be called with the associated
+     * mutex locked.
+     */
+    class Condition
+    {
+    public:
+        Condition();
+        virtual ~Condition() throw ();
+        void Wait(Mutex& iMutex);
+        void Signal();
+        void Broadcast();
+
+    private:
+        pthread_cond_t mCondition;
+    };
+}
+
+#endif /* THREAD_H */
@@ -8,6 +8,7 @@
  */
 
 #include "TimedLatch.h"
+#include "Kernel.h"
 
 Tracter::TimedLatch::TimedLatch(
     Component<BoolType>* iInput,
@@ -16,6 +17,7 @@ Tracter::TimedLatch::TimedLatch(
 {
     mObjectName = iObjectName;
     mFrame.size = iInput->Frame().size;
+    assert(mFrame.size == 1);
     mInput = iInput;
     Connect(iInput);
 
@@ -42,70 +44,50 @@ void Tracter::TimedLatch::Reset(bool iPropagate)
     CachedComponent<BoolType>::Reset(iPropagate);
 }
 
-bool Tracter::TimedLatch::UnaryFetch(IndexType iIndex, BoolType* oData)
+/**
+ * A change of state is suggested by an input frame that differs from
+ * the current state.  It is confirmed if the following frames, up to
+ * the confirmation time, agree with it; then they are all in the new
+ * state.  Otherwise, all the frames up to the first that agrees with
+ * the current state (or EOD) stay in the current state.  Either way,
+ * one look-ahead decides a run of frames.
+ */
+Tracter::SizeType Tracter::TimedLatch::ContiguousFetch(
+    IndexType iIndex, SizeType iLength, SizeType iOffset
+)
 {
     assert(iIndex >= 0);
-    assert(oData);
-    assert((mIndex < 0) || (iIndex = mIndex + 1));
-
-    const BoolType* state = mInput->UnaryRead(iIndex);
-    if (!state)
-        return false;
+    assert((mIndex < 0) || (iIndex == mIndex + 1));
 
-    /*
-     * This is a bit inefficient because it reads ahead for each
-     * successive frame that suggests a false change of state.  It
-     * would be much better if it were possible to write ahead too.
-     */
-    if (mState)
+    SizeType done = 0;
+    while (done < iLength)
     {
-        if (*state)
-        {
-            // true -> true
-            mState = true;
-        }
-        else
-        {
-            // true -> false?  Assume yes, then check for no.
-            mState = false;
-            for (int i=1; i<mConfirmFalseTime; i++)
-            {
-                state = mInput->UnaryRead(iIndex+i);
-                if (!state || *state)
-                {
-                    // Either EOD, or data saying true, so revert to true
-                    mState = true;
-                    break;
-                }
-            }
-        }
-    }
-    else
-    {
-        if (*state)
-        {
-            // false -> true?  Assume yes, then check for no.
-            mState = true;
-            for (int i=1; i<mConfirmTrueTime; i++)
-            {
-                state = mInput->UnaryRead(iIndex+i);
-                if (!state || !*state)
-                {
-                    // Either EOD, or data saying false, so revert to false
-                    mState = false;
-                    break;
-                }
-            }
-        }
-        else
-        {
-            // false -> false
-            mState = false;
-        }
+        // Look ahead by the time needed to confirm a change
+        IndexType index = iIndex + done;
+        int confirm = std::max(mState ? mConfirmFalseTime : mConfirmTrueTime, 1);
+        CacheArea inputArea;
+        SizeType got = mInput->Read(inputArea, index, confirm);
+        if (got == 0)
+            break;
+
+        // Count the frames that agree with the first one
+        bool suggest = *input(inputArea, 0);
+        SizeType len0 = std::min(got, inputArea.len[0]);
+        SizeType run = Kernel::FindFlag(input(inputArea, 0), len0, !suggest);
+        if ((run == len0) && (got > len0))
+            run += Kernel::FindFlag(
+                input(inputArea, len0), got - len0, !suggest
+            );
+        if ((suggest != mState) && (run == confirm))
+            mState = suggest;
+
+        // The run is all in the (new) current state
+        run = std::min(run, iLength - done);
+        for (SizeType i=0; i<run; i++)
+            *GetPointer(iOffset + done + i) = mState;
+        done += run;
     }
 
-    // The current output just drops out in mState
-    *oData = mState;
-    mIndex = iIndex;
-    return true;
+    mIndex = iIndex + done - 1;
+    return done;
 }
@@ -20,7 +20,8 @@ namespace Tracter
      * Timed latch
      *
      * Latches to true or false if the input stays in that state for
-     * long enough.
+     * long enough.  Each look-ahead decides a whole run of frames,
+     * which are written in one go.
      */
     class TimedLatch : public CachedComponent<BoolType>
     {
@@ -29,7 +30,9 @@ namespace Tracter
                    const char* iObjectName = "TimedLatch");
 
     protected:
-        bool UnaryFetch(IndexType iIndex, BoolType* oData);
+        SizeType ContiguousFetch(
+            IndexType iIndex, SizeType iLength, SizeType iOffset
+        );
         void Reset(bool iPropagate);
 
     private:
@@ -39,6 +42,14 @@ namespace Tracter
         bool mState;
         int mConfirmTrueTime;
         int mConfirmFalseTime;
+
+        const BoolType* input(const CacheArea& iArea, SizeType iIndex)
+        {
+            return mInput->GetPointer(
+                iIndex < iArea.len[0]
+                ? iArea.offset + iIndex : iIndex - iArea.len[0]
+            );
+        }
     };
 }
 
@@ -91,3 +91,28 @@ void Tracter::VADStateMachine::Update(bool iSpeech)
 
     //printf("Machine: mState is %d\n", mState);
 }
+
+/**
+ * Update the state machine with a run of iN decisions, writing the
+ * state after each one to oState.  A confirmed state can only change
+ * on a contrary decision, so runs that agree with it are just copied.
+ */
+void Tracter::VADStateMachine::Update(
+    const BoolType* iSpeech, VADState* oState, int iN
+)
+{
+    int i = 0;
+    while (i < iN)
+    {
+        if ((mState == SPEECH_CONFIRMED) || (mState == SILENCE_CONFIRMED))
+        {
+            bool speech = (mState == SPEECH_CONFIRMED);
+            while ((i < iN) && (iSpeech[i] == speech))
+                oState[i++] = mState;
+            if (i == iN)
+                break;
+        }
+        Update(iSpeech[i]);
+        oState[i++] = mState;
+    }
+}
@@ -41,6 +41,7 @@ namespace Tracter
 
     protected:
         void Update(bool iSpeech);
+        void Update(const BoolType* iSpeech, VADState* oState, int iN);
 
         VADState mState;
         int mTime;
@@ -5,6 +5,10 @@
  * See the file COPYING for the licence associated with this software.
  */
 
+#ifdef __SSE__
+# include <xmmintrin.h>
+#endif
+
 #include "ViterbiVAD.h"
 #include "math.h"
 
@@ -28,7 +32,7 @@ Tracter::ViterbiVAD::ViterbiVAD(
     // some sanity checks
     assert(mSilPrior > 0 && mSilPrior < 1);
     assert(mSilStates > 0 && mSpeechStates > 0);
-    assert(mLookAhead >= 0 );
+    assert(mLookAhead > 0);
 
     mEndSpeech = mSilStates + mSpeechStates - 1;
     mEndSil = mSilStates - 1;
@@ -38,7 +42,11 @@ Tracter::ViterbiVAD::ViterbiVAD(
 
     score.resize(mSilStates+mSpeechStates,0.0);
     tmp_score.resize(mSilStates+mSpeechStates,0.0);
-    
+    int bits = sizeof(LabelWord) * 8;
+    mWords = (mLookAhead + bits - 1) / bits;
+    mLabel.resize((mSilStates+mSpeechStates) * mWords, 0);
+    mTmpLabel.resize((mSilStates+mSpeechStates) * mWords, 0);
+
     Connect(iInput,mLookAhead);
 }
 
@@ -55,8 +63,6 @@ void Tracter::ViterbiVAD::Reset(bool iPropagate)
     mIndex = 0;
     mLookAheadIndex = -1;
     mEndOfData = -1;
-
-    traceback.clear();
 }
 
 bool Tracter::ViterbiVAD::UnaryFetch(IndexType iIndex, VADState* oData)
@@ -80,87 +86,86 @@ bool Tracter::ViterbiVAD::UnaryFetch(IndexType iIndex, VADState* oData)
 bool Tracter::ViterbiVAD::getVADState(IndexType iIndex)
 {
     assert(iIndex >= 0);
+    if (mEndOfData >= 0 && iIndex >= mEndOfData)
+      return false;
 
+    // Run the search forward until the state of iIndex is decided
+    mIndex = iIndex;
+    VADState v;
     CacheArea inputArea;
-    if (iIndex == 0){ // special case to take into account Viterbi lookahead
-      // first get the lookahead working
-      for (int i = 0; i < mLookAhead-1; i++){
-	//printf("Read input %i\n",i); fflush(stdout);
-	if (mInput->Read(inputArea, i) == 0){
-	  Verbose(2, "getVADState: End Of Data at %ld\n", i);
-	  return false;
-	}
-	assert(inputArea.Length() == 1);
-	float* p = mInput->GetPointer(inputArea.offset);
-	//printf("SilProb[%i] %f\n",i,*p);
-	doForward(i,*p);
-	VADState v;
-	doTraceback(0,v);
+    while (!decide(iIndex, v)){
+      IndexType next = mLookAheadIndex + 1;
+      //printf("Read input %i\n",next); fflush(stdout);
+      if (mInput->Read(inputArea, next) == 0){
+        Verbose(2, "getVADState: End Of Data at %lld\n", next);
+        mEndOfData = next;
+        if (iIndex >= mEndOfData)
+          return false;
+        continue;
       }
-    }else if (iIndex >= mEndOfData && mEndOfData >= 0){
-      return false;
-    }
-
-    //printf("Read input %i\n",iIndex+mLookAhead-1); fflush(stdout);
-    if (mEndOfData >= 0){
-      // do nothing
-    }else if (mInput->Read(inputArea, iIndex+mLookAhead-1) == 0){
-      Verbose(2, "getVADState: End Of Data at %ld\n", iIndex+mLookAhead-1);
-      mEndOfData = iIndex+mLookAhead-1;
-    }else{
       assert(inputArea.Length() == 1);
       float* p = mInput->GetPointer(inputArea.offset);
-      //printf("SilProb[%i] %f\n",iIndex+mLookAhead-1,*p);
-      doForward(iIndex+mLookAhead-1,*p);
-    }
-
-    VADState v;
-    if (doTraceback(iIndex,v)){
-      mState = v;
-    }else{
-      return false;
+      //printf("SilProb[%i] %f\n",next,*p);
+      doForward(next,*p);
     }
 
+    mState = v;
     return true;
 }
 
-//  makes the traceback of the viterbi decoding given the starting point 
-//  (max_index is index of max scoring path)
-bool Tracter::ViterbiVAD::doTraceback(IndexType iIndex, VADState &vad_state){
-  assert(iIndex <= mLookAheadIndex && iIndex >= mIndex);
-
-  int tb_index = mBestState;
-  //printf("    tb_index: %i -> %i\n",mLookAheadIndex,tb_index); fflush(stdout);
-
-  if (traceback.size() == 0)
+//  the state at iIndex, if it's known.  It is once every state's best
+//  path agrees on it, as the eventual best path descends from one of
+//  them.  Otherwise it's taken from the current best path when the
+//  lookahead is used up or the data have ended.
+bool Tracter::ViterbiVAD::decide(IndexType iIndex, VADState &vad_state){
+  if (mLookAheadIndex < iIndex)
     return false;
-
-  IndexType i = mLookAheadIndex;
-  for (std::deque< std::vector<int> >::reverse_iterator it=traceback.rbegin(); 
-       it != traceback.rend() && i != iIndex;
-       it++, i--){
-    tb_index = (*it)[tb_index];
-    //printf("    tb_index: %i -> %i\n",i-1,tb_index); fflush(stdout);
-  }
- 
-  if (tb_index >= mSilStates){
-    vad_state = SPEECH_TRIGGERED;
-    //printf("  traceback at %i is SPEECH\n", i); fflush(stdout);
-  }else{
-    vad_state = SILENCE_TRIGGERED;
-    //printf("  traceback at %i is SILENCE\n", i); fflush(stdout);
+  int age = (int)(mLookAheadIndex - iIndex);
+  assert(age < mLookAhead);
+  int bits = sizeof(LabelWord) * 8;
+  int word = age / bits;
+  LabelWord bit = (LabelWord)1 << (age % bits);
+
+  LabelWord any = 0;
+  LabelWord all = ~(LabelWord)0;
+  int nStates = mSilStates+mSpeechStates;
+  for (int i=0; i<nStates; i++){
+    any |= mLabel[i*mWords + word];
+    all &= mLabel[i*mWords + word];
   }
 
+  bool speech;
+  if (!(any & bit))
+    speech = false;
+  else if (all & bit)
+    speech = true;
+  else if (age == mLookAhead-1 || mEndOfData >= 0)
+    speech = (mLabel[mBestState*mWords + word] & bit) != 0;
+  else
+    return false;
+
+  vad_state = speech ? SPEECH_TRIGGERED : SILENCE_TRIGGERED;
   return true;
 }
 
+//  the labels of iFrom's path, a frame older, become those of iState;
+//  only the first iWords words are kept up to date
+void Tracter::ViterbiVAD::exchange(
+  int iState, int iFrom, bool iSpeech, int iWords
+){
+  const LabelWord* from = &mLabel[iFrom*mWords];
+  LabelWord* to = &mTmpLabel[iState*mWords];
+  int top = sizeof(LabelWord) * 8 - 1;
+  for (int w=iWords-1; w>0; w--)
+    to[w] = (from[w] << 1) | (from[w-1] >> top);
+  to[0] = (from[0] << 1) | (iSpeech ? 1 : 0);
+}
 
 // this advances the viterbi search forward one frame using the given silence posterior probability
 void Tracter::ViterbiVAD::doForward(IndexType iIndex, float pSil){
   // check that iIndex is one frame advanced from last one (or reset has been previously called)
   if (mLookAheadIndex == -1){
     mLookAheadIndex = iIndex;
-    mIndex = iIndex;
   }else{
     mLookAheadIndex++;
   }
@@ -170,107 +175,73 @@ void Tracter::ViterbiVAD::doForward(IndexType iIndex, float pSil){
   float lSil = logf(pSil/mSilPrior);
   float lSpeech = logf((1.0-pSil)/mSpeechPrior);
 
-  //  printf("============== %i ===============\n",iIndex);
-  //printf("iIndex: %i   lSil: %f     lSpeech %f\n",iIndex,lSil,lSpeech);
-
-  // take care of the traceback first (if traceback history is full, we use pop/push as in a circular buffer, otherwise add new traceback)
-  if (mLookAhead == (int)traceback.size()){
-    //printf("tb: circular buffer\n");
-    mIndex++;
-    std::vector<int> &tmp_tb = traceback.front();
-    traceback.pop_front();
-    traceback.push_back(tmp_tb);
-    //traceback.push_back(std::vector<int>(mSilStates+mSpeechStates));
-  }else if (pSil < 0 && traceback.size() > 0){
-    //printf("tb: end buffer\n");
-    mIndex++;
-    traceback.pop_front();
-    return;
-  }else{
-    //printf("tb: new buffer\n");
-    //traceback.push_back(*(new std::vector<int>(mSilStates+mSpeechStates)));
-    traceback.push_back(std::vector<int>(mSilStates+mSpeechStates));
-  }
-  std::vector<int> &tb = traceback.back();
- 
-  // process likelihoods of Sil states
+  // The first state of each chain is a choice
+  int silFrom = 0;
   float tmp_score_a = lSil + score[0];
   float tmp_score_b = lSil + mInsPen + score[mEndSpeech];
   if (tmp_score_a >= tmp_score_b){
-    tmp_score[0] = tmp_score_a; 
-    tb[0] = 0;
+    tmp_score[0] = tmp_score_a;
   }else{
     tmp_score[0] = tmp_score_b;
-    tb[0] = mEndSpeech;
+    silFrom = mEndSpeech;
   }
-  float max_score = tmp_score[0];
-  mBestState = 0;
-
-  for (int i = 1; i < mSilStates; i++){
-    tmp_score[i] = lSil + score[i-1];
-    tb[i] = i-1;
-
-    //tmp_score_a = lSil + score[i];
-    //tmp_score_b = lSil + score[i-1];
-    //if (tmp_score_a >= tmp_score_b){
-    //  tmp_score[i] = tmp_score_a;
-    //  tb[i] = i;
-    //}else{
-    //  tmp_score[0] = tmp_score_b;
-    //  tb[i] = i-1;
-    //}
-
-    if (tmp_score[i] > max_score){
-      max_score = tmp_score[i];
-      mBestState = tb[i];
-    }
-  }
-
-  // process likelihoods of Speech states
+  int speechFrom = mSilStates;
   tmp_score_a = lSpeech + score[mSilStates];
   tmp_score_b = lSpeech + mInsPen + score[mEndSil];
   if (tmp_score_a >= tmp_score_b){
     tmp_score[mSilStates] = tmp_score_a;
-    tb[mSilStates] = mSilStates;
   }else{
     tmp_score[mSilStates] = tmp_score_b;
-    tb[mSilStates] = mEndSil;
-  }
-  if (tmp_score[mSilStates] > max_score){
-      max_score = tmp_score[mSilStates];
-      mBestState = mSilStates;
+    speechFrom = mEndSil;
   }
 
-  for (int i = mSilStates+1; i < mSilStates+mSpeechStates; i++){
-    tmp_score[i] = lSpeech + score[i-1];
-    tb[i] = i-1;
+  // The rest of each chain just shifts along one state
+  advance(lSil, 1, mSilStates);
+  advance(lSpeech, mSilStates+1, mSilStates+mSpeechStates);
 
-    //tmp_score_a = lSpeech + score[i];
-    //tmp_score_b = lSpeech + score[i-1];
-    //if (tmp_score_a >= tmp_score_b){
-    //  tmp_score[i] = tmp_score_a;
-    //  tb[i] = i;
-    //}else{
-    //  tmp_score[0] = tmp_score_b;
-    //  tb[i] = i-1;
-    //}
-
-    if (tmp_score[i] > max_score){
-      max_score = tmp_score[i];
-      mBestState = tb[i];
-    }
-  }
+  // The best state is the first one with the highest score
+  int nStates = mSilStates+mSpeechStates;
+  float max_score = tmp_score[0];
+  int i = 1;
+#ifdef __SSE__
+  __m128 vmax = _mm_set1_ps(max_score);
+  for (; i<=nStates-4; i+=4)
+    vmax = _mm_max_ps(vmax, _mm_loadu_ps(&tmp_score[i]));
+  float part[4];
+  _mm_storeu_ps(part, vmax);
+  max_score = std::max(std::max(part[0], part[1]), std::max(part[2], part[3]));
+#endif
+  for (; i<nStates; i++)
+    max_score = std::max(max_score, tmp_score[i]);
+  mBestState = 0;
+  while (tmp_score[mBestState] < max_score)
+    mBestState++;
 
   // move the new scores into their proper place
   score.swap(tmp_score);
 
-  //for (int i = 0; i < mSilStates + mSpeechStates; i++){
-  //  printf("score[%i]: %f\n",i,score[i]);
-  //}
-  //printf("max index: %i score %f\n",mBestState,max_score);
-
-  //VADState vad_state;
-  //doTraceback(iIndex, vad_state);
+  // The labels follow the same transitions as the scores.  Frames
+  // before mIndex have been output, so their labels aren't needed.
+  int bits = sizeof(LabelWord) * 8;
+  int words = (int)std::max(mLookAheadIndex - mIndex, (IndexType)0) / bits + 1;
+  words = std::min(words, mWords);
+  exchange(0, silFrom, false, words);
+  for (i=1; i<mSilStates; i++)
+    exchange(i, i-1, false, words);
+  exchange(mSilStates, speechFrom, true, words);
+  for (i=mSilStates+1; i<nStates; i++)
+    exchange(i, i-1, true, words);
+  mLabel.swap(mTmpLabel);
+}
 
-  return;
+// tmp_score[i] = iScore + score[i-1] for i in [iBegin, iEnd)
+void Tracter::ViterbiVAD::advance(float iScore, int iBegin, int iEnd){
+  int i = iBegin;
+#ifdef __SSE__
+  __m128 s = _mm_set1_ps(iScore);
+  for (; i<=iEnd-4; i+=4)
+    _mm_storeu_ps(&tmp_score[i], _mm_add_ps(s, _mm_loadu_ps(&score[i-1])));
+#endif
+  for (; i<iEnd; i++)
+    tmp_score[i] = iScore + score[i-1];
 }
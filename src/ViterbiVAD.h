@@ -9,7 +9,7 @@
 #define VITERBIVAD_H
 
 #include <algorithm>
-#include <deque>
+#include <vector>
 
 #include "CachedComponent.h"
 #include "VADStateMachine.h" // we use the state machine states, though only speech confirmed/silence confirmed are used
@@ -20,7 +20,8 @@ namespace Tracter
   /**
    * Statistical based voice activity detection.  Inputs are the silence class posterior probabilities
    * e.g. from an MLP.  Voicing decision is smoothed using HMM with sil/speech minimum
-   * duration.
+   * duration.  A frame's decision is output as soon as every path still in the search
+   * agrees on it, and at the latest Lookahead frames on.
    */
 
   class ViterbiVAD : public CachedComponent<VADState>
@@ -44,7 +45,16 @@ namespace Tracter
 
     std::vector<float> score;                 // contains the score of states for viterbi search at current frame
     std::vector<float> tmp_score;             // temporary container for calculating scores for next frame
-    std::deque< std::vector<int> > traceback;   // container for traceback information
+
+    // Register exchange rather than traceback: each state keeps the
+    // speech (1) or silence (0) label of every frame of the lookahead
+    // on its best path, newest in bit 0 of the first of mWords words.
+    // A frame is decided as soon as all the states agree on it, and
+    // only the words back to the oldest undecided frame are updated.
+    typedef unsigned long long LabelWord;
+    int mWords;
+    std::vector<LabelWord> mLabel;
+    std::vector<LabelWord> mTmpLabel;
 
   public:
     public:
@@ -64,9 +74,12 @@ namespace Tracter
 
 	bool getVADState(IndexType iIndex);
 
-	void doForward(IndexType iIndex, float pSil = -1.0);
+	void doForward(IndexType iIndex, float pSil);
+
+	bool decide(IndexType iIndex, VADState &vad_state);
 
-	bool doTraceback(IndexType iIndex, VADState &vad_state);
+	void exchange(int iState, int iFrom, bool iSpeech, int iWords);
+	void advance(float iScore, int iBegin, int iEnd);
   };
 
 }
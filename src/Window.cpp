@@ -4,6 +4,7 @@
  * See the file COPYING for the licence associated with this software.
  */
 
+#include <cassert>
 #include <cmath>
 #include <map>
 #include <string>
@@ -89,3 +90,19 @@ float* Tracter::Window::Apply(const float* iData, float* oData) const
         oData[i] = iData[i] * mWeight[i];
     return oData;
 }
+
+/**
+ * Apply just part of the window: iLength weights from iOffset.  Lets
+ * a frame that is split across a circular cache be windowed in place.
+ */
+float* Tracter::Window::Apply(
+    const float* iData, float* oData, int iOffset, int iLength
+) const
+{
+    assert(iOffset >= 0);
+    assert(iOffset + iLength <= (int)mWeight.size());
+    const float* weight = &mWeight[0] + iOffset;
+    for (int i=0; i<iLength; i++)
+        oData[i] = iData[i] * weight[i];
+    return oData;
+}
@@ -34,6 +34,9 @@ namespace Tracter
         virtual ~Window() throw () {}
         void Resize(int iSize, bool iDivideN = false);
         float* Apply(const float* iData, float* oData) const;
+        float* Apply(
+            const float* iData, float* oData, int iOffset, int iLength
+        ) const;
         const float operator[](int iIndex) {
             return mWeight[iIndex];
         }
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "TracterObject.h"
+#include "XForm.h"
+
+namespace Tracter
+{
+    const char cXFormMagic[8] = {'t','r','a','c','t','e','r','X'};
+
+    /** Header of the binary format; the matrix follows directly */
+    struct XFormHeader
+    {
+        char magic[8];
+        int rows;
+        int cols;
+    };
+}
+
+Tracter::XForm::XForm(const char* iObjectName)
+{
+    mObjectName = iObjectName;
+    mRows = 0;
+    mCols = 0;
+    mData = 0;
+    mMap = 0;
+    mMapSize = 0;
+}
+
+Tracter::XForm::~XForm()
+{
+    if (mMap)
+        munmap(mMap, mMapSize);
+}
+
+void Tracter::XForm::Load(const char* iFileName)
+{
+    if (!iFileName)
+        throw Exception("%s: Null file name", mObjectName);
+    if (!loadBinary(iFileName))
+        loadText(iFileName);
+}
+
+/**
+ * Map a binary file.  Returns false if it isn't one.
+ */
+bool Tracter::XForm::loadBinary(const char* iFileName)
+{
+    int fd = open(iFileName, O_RDONLY);
+    if (fd < 0)
+        throw Exception("%s: Failed to open file %s", mObjectName, iFileName);
+
+    XFormHeader header;
+    struct stat buf;
+    if ((read(fd, &header, sizeof(header)) != sizeof(header)) ||
+        memcmp(header.magic, cXFormMagic, sizeof(header.magic)))
+    {
+        close(fd);
+        return false;
+    }
+    if ((fstat(fd, &buf) < 0) ||
+        (buf.st_size < (off_t)(sizeof(header) +
+                               (size_t)header.rows * header.cols *
+                               sizeof(float))))
+    {
+        close(fd);
+        throw Exception("%s: %s is truncated", mObjectName, iFileName);
+    }
+
+    mMapSize = buf.st_size;
+    mMap = mmap(0, mMapSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mMap == MAP_FAILED)
+    {
+        mMap = 0;
+        perror(mObjectName);
+        throw Exception("%s: mmap() failed for %s", mObjectName, iFileName);
+    }
+
+    mRows = header.rows;
+    mCols = header.cols;
+    mData = (const float*)((const char*)mMap + sizeof(header));
+    return true;
+}
+
+/**
+ * Read an HTK style text file.
+ */
+void Tracter::XForm::loadText(const char* iFileName)
+{
+    FILE* fp = fopen(iFileName, "r");
+    if (!fp)
+        throw Exception("Failed to open file %s", iFileName);
+
+    /* Read until the <XForm> tag */
+    char tmpStr[1024] = "";
+    do
+    {
+        if (fscanf(fp, "%1023s", tmpStr) != 1)
+        {
+            fclose(fp);
+            throw Exception("Failed to read <XForm> token");
+        }
+    }
+    while (strncasecmp(tmpStr, "<Xform>", 1024));
+
+    /* Read the row and column dimensions */
+    if (fscanf(fp, "%d %d", &mRows, &mCols) != 2)
+    {
+        fclose(fp);
+        throw Exception("Failed to read size tokens");
+    }
+
+    /* And finally the matrix itself */
+    int size = mRows * mCols;
+    mMatrix.resize(size);
+    for (int i=0; i<size; i++)
+        if (fscanf(fp, "%f", &mMatrix[i]) != 1)
+        {
+            fclose(fp);
+            throw Exception("failed to read element %d", i);
+        }
+
+    /* Done */
+    fclose(fp);
+    mData = &mMatrix[0];
+}
+
+/**
+ * Write the binary format.
+ */
+void Tracter::XForm::Save(const char* iFileName) const
+{
+    assert(iFileName);
+    FILE* fp = fopen(iFileName, "wb");
+    if (!fp)
+        throw Exception("%s: Failed to open file %s", mObjectName, iFileName);
+
+    XFormHeader header;
+    memcpy(header.magic, cXFormMagic, sizeof(header.magic));
+    header.rows = mRows;
+    header.cols = mCols;
+    size_t size = (size_t)mRows * mCols;
+    if ((fwrite(&header, sizeof(header), 1, fp) != 1) ||
+        (fwrite(mData, sizeof(float), size, fp) != size))
+    {
+        fclose(fp);
+        throw Exception("%s: Failed to write file %s", mObjectName, iFileName);
+    }
+    fclose(fp);
+}
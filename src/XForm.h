@@ -0,0 +1,56 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#ifndef XFORM_H
+#define XFORM_H
+
+#include <vector>
+#include <cstddef>
+
+namespace Tracter
+{
+    /**
+     * A matrix stored row major, as used by LinearTransform.
+     *
+     * Load() reads either an HTK style text file (the matrix follows
+     * an <XForm> tag and its row and column dimensions) or the binary
+     * format written by Save().  The binary format is a 16 byte
+     * header, the magic "tracterX" then the rows and columns as 32 bit
+     * ints, followed by the floats themselves, all in native byte
+     * order.  A binary file is mapped rather than read, so even large
+     * matrices load instantly.
+     */
+    class XForm
+    {
+    public:
+        XForm(const char* iObjectName = "XForm");
+        ~XForm();
+
+        void Load(const char* iFileName);
+        void Save(const char* iFileName) const;
+
+        int Rows() const { return mRows; }
+        int Cols() const { return mCols; }
+        const float* Data() const { return mData; }
+
+    private:
+        XForm(const XForm&);
+        XForm& operator =(const XForm&);
+
+        const char* mObjectName;
+        int mRows;
+        int mCols;
+        const float* mData;
+        std::vector<float> mMatrix;
+        void* mMap;
+        size_t mMapSize;
+
+        bool loadBinary(const char* iFileName);
+        void loadText(const char* iFileName);
+    };
+}
+
+#endif /* XFORM_H */
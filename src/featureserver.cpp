@@ -0,0 +1,50 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <cstdio>
+#include <csignal>
+
+#include "FeatureServer.h"
+
+using namespace Tracter;
+
+static FeatureServer* sServer = 0;
+
+static void stop(int iSignal)
+{
+    if (sServer)
+        sServer->Stop();
+}
+
+/**
+ * Feature server executable.  Serves the front-end chosen by the
+ * usual ASRFactory configuration to any number of clients.
+ */
+int main(int argc, char** argv)
+{
+    try
+    {
+        ASRFactory factory;
+        FeatureServer server(&factory);
+        sServer = &server;
+        signal(SIGINT, stop);
+        signal(SIGTERM, stop);
+        server.Serve();
+        sServer = 0;
+    }
+    catch(std::exception& e)
+    {
+        fprintf(stderr, "Caught exception: %s\n", e.what());
+        return 1;
+    }
+    catch(...)
+    {
+        fprintf(stderr, "Caught unknown exception\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "HTKSource.h"
+#include "FrameSink.h"
+#include "NeuralNet.h"
+
+using namespace Tracter;
+
+/* The default MLP_Block */
+const int cBlock = 16;
+
+/*
+ * Compare the outputs of the 8 bit MLP with those of the float one on
+ * a feature file, i.e., what setting MLP_Quantise would do to the
+ * posteriors.  The window size is deduced from the network and the
+ * feature size.
+ */
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        printf("Usage: %s <weights> <HTK features>\n", argv[0]);
+        return 1;
+    }
+
+    NeuralNet net;
+    NeuralNet qnet;
+    net.Load(argv[1]);
+    qnet.Load(argv[1]);
+    qnet.Quantise();
+
+    // Read all the features, duplicating those at the edges
+    HTKSource* source = new HTKSource();
+    FrameSink<float> sink(source);
+    source->Open(argv[2]);
+    int size = source->Frame().size;
+    int window = net.Inputs() / size;
+    if ((window * size != net.Inputs()) || (window % 2 == 0))
+    {
+        printf("Network inputs %d don't fit features of size %d\n",
+               net.Inputs(), size);
+        return 1;
+    }
+    int theta = window / 2;
+    std::vector<float> features;
+    const float* frame;
+    int nFrames = 0;
+    while ((frame = sink.Read(nFrames)))
+    {
+        for (int i=0; i<(nFrames ? 1 : theta+1); i++)
+            features.insert(features.end(), frame, frame + size);
+        nFrames++;
+    }
+    if (nFrames == 0)
+    {
+        printf("No frames in %s\n", argv[2]);
+        return 1;
+    }
+    std::vector<float> last(features.end() - size, features.end());
+    for (int i=0; i<theta; i++)
+        features.insert(features.end(), last.begin(), last.end());
+
+    int outputs = net.Outputs();
+    std::vector<float> output(nFrames * outputs);
+    std::vector<float> qoutput(nFrames * outputs);
+    for (int f=0; f<nFrames; f+=cBlock)
+    {
+        // In blocks, like MLP, as the 8 bit input scale is per block
+        int n = std::min(cBlock, nFrames - f);
+        net.ForwardWindow(&features[f * size], window,
+                          &output[f * outputs], outputs, n);
+        qnet.ForwardWindow(&features[f * size], window,
+                           &qoutput[f * outputs], outputs, n);
+    }
+
+    double maxError = 0.0;
+    double sumError = 0.0;
+    int agree = 0;
+    for (int f=0; f<nFrames; f++)
+    {
+        float* o = &output[f * outputs];
+        float* q = &qoutput[f * outputs];
+        for (int i=0; i<outputs; i++)
+        {
+            double error = fabs(o[i] - q[i]);
+            maxError = std::max(maxError, error);
+            sumError += error;
+        }
+        if (std::max_element(o, o + outputs) - o ==
+            std::max_element(q, q + outputs) - q)
+            agree++;
+    }
+    printf("%d frames, %d x %d inputs, %d outputs\n",
+           nFrames, window, size, outputs);
+    printf("Mean absolute error: %g\n", sumError / (nFrames * outputs));
+    printf("Max absolute error:  %g\n", maxError);
+    printf("Same maximum:        %.2f%%\n", 100.0 * agree / nFrames);
+    return 0;
+}
@@ -21,14 +21,12 @@
 #include <Select.h>
 
 #ifdef HAVE_BSAPI
-#ifdef HAVE_TORCH3
 # include <ViterbiVAD.h>
 # include <ViterbiVADGate.h>
 # include <BSAPIFrontEnd.h>
 # include <MLP.h>
 # include <MLPVAD.h>
 #endif
-#endif
 
 #include "Minima.h"
 #include "Comparator.h"
@@ -73,12 +71,11 @@ public:
             // Modulation VAD
         case MODULATION:
         {
-            Component<float>* v = p;
-            v = new Frame(v);
-            v = new Energy(v);
+            // The VAD and the gate share the framing
+            p = new Frame(p);
+            Component<float>* v = new Energy(p);
             Modulation* m = new Modulation(v);
             sm = new NoiseVAD(m, v);
-            p = new Frame(p);
             p = new VADGate(p, sm);
             p = new Unframe(p);
             break;
@@ -87,21 +84,19 @@ public:
         // New Modulation VAD
         case NEW_MODULATION:
         {
-            Component<float>* v = p;
-            v = new Frame(v);
-            v = new Energy(v);
+            // The VAD and the gate share the framing
+            p = new Frame(p);
+            Component<float>* v = new Energy(p);
             Modulation* m = new Modulation(v);
             Component<float>* n = new Minima(v);
             Component<BoolType>* b = new Comparator(m, n);
             b = new TimedLatch(b);
-            p = new Frame(p);
             p = new Gate(p, b);
             p = new Unframe(p);
             break;
         }
 
 #ifdef HAVE_BSAPI
-#ifdef HAVE_TORCH3
         // MLP VAD
         case MLP:
         {
@@ -159,7 +154,6 @@ public:
             break;
         }
 
-#endif
 #endif
         default:
             Verbose(1, "No VAD, or not compiled in\n");
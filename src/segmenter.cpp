@@ -0,0 +1,43 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <stdio.h>
+
+#include "SegmentDispatcher.h"
+
+using namespace Tracter;
+
+/**
+ * Segmenter executable.  Runs a VAD over a file and extracts features
+ * for each speech segment in parallel.
+ */
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "Usage: segmenter infile outfile\n");
+        return 1;
+    }
+
+    try
+    {
+        ASRFactory factory;
+        SegmentDispatcher dispatcher(&factory);
+        dispatcher.File(argv[1], argv[2]);
+    }
+    catch(std::exception& e)
+    {
+        fprintf(stderr, "Caught exception: %s\n", e.what());
+        return 1;
+    }
+    catch(...)
+    {
+        fprintf(stderr, "Caught unknown exception\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2011 by Idiap Research Institute, http://www.idiap.ch
+ *
+ * See the file COPYING for the licence associated with this software.
+ */
+
+#include <cstdio>
+#include <exception>
+
+#include "XForm.h"
+
+using namespace Tracter;
+
+/*
+ * Convert a LinearTransform matrix to the binary format, which loads
+ * without parsing.
+ */
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        printf("Usage: %s <input xform> <output xform>\n", argv[0]);
+        return 1;
+    }
+
+    try
+    {
+        XForm xform;
+        xform.Load(argv[1]);
+        xform.Save(argv[2]);
+        printf("%d x %d\n", xform.Rows(), xform.Cols());
+    }
+    catch(std::exception& e)
+    {
+        fprintf(stderr, "Caught exception: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}